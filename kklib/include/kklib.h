@@ -375,6 +375,20 @@ typedef struct kk_yield_s {
 
 extern kk_ptr_t kk_evv_empty_singleton;
 
+// Effect handler profiling events (counted per handler tag when enabled with the `--kkprofile` option)
+typedef enum kk_prof_event_e {
+  KK_PROF_OPERATION,   // operation invocations (evidence access by index)
+  KK_PROF_YIELD,       // yields to a handler
+  KK_PROF_EXTEND,      // continuation extensions while yielding
+  KK_PROF_COMPOSE,     // allocated continuation compositions
+  KK_PROF_LOOKUP,      // dynamic evidence lookups
+  KK_PROF_EVV_ALLOC,   // allocated evidence vectors
+  KK_PROF_EVENTS
+} kk_prof_event_t;
+
+struct kk_prof_s;
+struct kk_output_s;
+
      
 // The thread local context.
 // The fields `yielding`, `heap` and `evv` should come first for efficiency
@@ -393,6 +407,8 @@ typedef struct kk_context_s {
   kk_task_group_t* task_group;     // task group for managing threads. NULL for the main thread.
   
   struct kk_random_ctx_s* srandom_ctx; // strong random using chacha20, initialized on demand
+  struct kk_prof_s* prof;          // effect handler profile counters, only allocated with the `--kkprofile` option
+  struct kk_output_s* output;      // buffered console output, initialized on demand
   kk_ssize_t     argc;             // command line argument count 
   const char**   argv;             // command line arguments
   kk_timer_t     process_start;    // time at start of the process
@@ -410,6 +426,13 @@ kk_decl_export void          kk_free_context(void);
 kk_decl_export kk_context_t* kk_main_start(int argc, char** argv);
 kk_decl_export void          kk_main_end(kk_context_t* ctx);
 
+kk_decl_export void          kk_prof_count(const char* tag, kk_prof_event_t event, kk_context_t* ctx);
+
+// Is effect handler profiling enabled?
+static inline bool kk_prof_enabled(kk_context_t* ctx) {
+  return (ctx->prof != NULL);
+}
+
 kk_decl_export void          kk_debugger_break(kk_context_t* ctx);
 
 // The current context is passed as a _ctx parameter in the generated code
@@ -770,7 +793,7 @@ static inline void kk_reuse_drop(kk_reuse_t r, kk_context_t* ctx) {
                   is `_base` and points to the base type as a `basetype`
 --------------------------------------------------------------------------------------*/
 
-//#define kk_basetype_tag(v)                     (kk_block_tag(&((v)->_block)))
+#define kk_basetype_tag(v)                     (kk_block_tag(&((v)->_block)))
 #define kk_basetype_has_tag(v,t)               (kk_block_has_tag(&((v)->_block),t))
 #define kk_basetype_is_unique(v)               (kk_block_is_unique(&((v)->_block)))
 #define kk_basetype_as(tp,v)                   (kk_block_as(tp,&((v)->_block)))
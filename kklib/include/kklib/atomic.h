@@ -36,6 +36,7 @@
 #define kk_atomic_cas_weak_acq_rel(p,exp,des)   kk_atomic(compare_exchange_weak_explicit)(p,exp,des,kk_memory_order(acq_rel),kk_memory_order(acquire))
 #define kk_atomic_cas_strong_relaxed(p,exp,des) kk_atomic(compare_exchange_strong_explicit)(p,exp,des,kk_memory_order(relaxed),kk_memory_order(relaxed))
 #define kk_atomic_cas_strong_acq_rel(p,exp,des) kk_atomic(compare_exchange_strong_explicit)(p,exp,des,kk_memory_order(acq_rel),kk_memory_order(acquire))
+#define kk_atomic_exchange_acq_rel(p,x)         kk_atomic(exchange_explicit)(p,x,kk_memory_order(acq_rel))
 
 #define kk_atomic_add_relaxed(p,x)          kk_atomic(fetch_add_explicit)(p,x,kk_memory_order(relaxed))
 #define kk_atomic_add_release(p,x)          kk_atomic(fetch_add_explicit)(p,x,kk_memory_order(release))
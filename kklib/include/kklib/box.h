@@ -220,8 +220,80 @@ static inline kk_box_t kk_int16_box(int16_t i, kk_context_t* ctx) {
 #endif
 
 #if (KK_INTPTR_SIZE == 8) && KK_BOX_DOUBLE64
-kk_decl_export kk_box_t kk_double_box(double d, kk_context_t* ctx);
-kk_decl_export double   kk_double_unbox(kk_box_t b, kk_context_t* ctx);
+// The value encodings are inlined as boxing doubles is common in polymorphic code;
+// only the (rare) heap allocated doubles go through a function call.
+kk_decl_export kk_box_t kk_double_box_heap(double d, kk_context_t* ctx);
+kk_decl_export double   kk_double_unbox_heap(kk_box_t b, kk_context_t* ctx);
+
+#if (KK_BOX_DOUBLE64 == 2)  // heap allocate when negative
+static inline kk_box_t kk_double_box(double d, kk_context_t* ctx) {
+  uint64_t u = kk_bits_from_double(d);
+  if (kk_likely((int64_t)u >= 0)) {  // positive?
+    kk_box_t b = { ((uintptr_t)u<<1)|1 };
+    return b;
+  }
+  else {
+    return kk_double_box_heap(d, ctx);
+  }
+}
+
+static inline double kk_double_unbox(kk_box_t b, kk_context_t* ctx) {
+  if (kk_likely(kk_box_is_value(b))) {
+    // positive double
+    return kk_bits_to_double(kk_shrp(b.box, 1));
+  }
+  else {
+    return kk_double_unbox_heap(b, ctx);
+  }
+}
+#else  // heap allocate when the exponent is between 0x200 and 0x5FF.
+static inline kk_box_t kk_double_box(double d, kk_context_t* ctx) {
+  uint64_t u = kk_bits_from_double(d);
+  u = kk_bits_rotl64(u, 12);
+  uint64_t exp = u & 0x7FF;
+  u -= exp;
+  // adjust to 10-bit exponent (if possible)
+  if (kk_likely(exp > 0x200 && exp < 0x5FF)) {  // absolute value between [2^-510,2^512)
+    exp -= 0x200;
+  }
+  else if (exp==0) { // zero or subnormal
+    // already good
+  }
+  else if (exp==0x7FF) { // infinity or NaN
+    exp = 0x3FF;
+  }
+  else {
+    // outside our range, heap allocate (outside [2^-510,2^512) and not 0, subnormal, NaN or Inf)
+    return kk_double_box_heap(d, ctx);
+  }
+  kk_assert_internal(exp <= 0x3FF);
+  kk_box_t b = { (u | (exp<<1) | 1) };
+  return b;
+}
+
+static inline double kk_double_unbox(kk_box_t b, kk_context_t* ctx) {
+  if (kk_likely(kk_box_is_value(b))) {
+    // expand 10-bit exponent to 11-bits again
+    uint64_t u = b.box;
+    uint64_t exp = u & 0x7FF;
+    u -= exp;    // clear lower 11 bits
+    exp >>= 1;
+    if (kk_likely(exp != 0 && exp != 0x3FF)) {
+      exp += 0x200;
+    }
+    else if (exp==0x3FF) {
+      exp = 0x7FF;
+    }
+    kk_assert_internal(exp <= 0x7FF);
+    u = kk_bits_rotr64(u | exp, 12);
+    return kk_bits_to_double(u);
+  }
+  else {
+    // heap allocated
+    return kk_double_unbox_heap(b, ctx);
+  }
+}
+#endif
 #else
 static inline double kk_double_unbox(kk_box_t b, kk_context_t* ctx) {
   int64_t i = kk_int64_unbox(b, ctx);
@@ -26,15 +26,63 @@ kk_decl_export int  kk_os_read_line(kk_string_t* result, kk_context_t* ctx);
 kk_decl_export int  kk_os_read_text_file(kk_string_t path, kk_string_t* result, kk_context_t* ctx);
 kk_decl_export int  kk_os_write_text_file(kk_string_t path, kk_string_t content, kk_context_t* ctx);
 
+// Write a vector of strings to a temporary file (using `writev`) and atomically rename it to `path`.
+// With `KK_FSYNC_FILE` the contents are synced before the rename, and with `KK_FSYNC_FULL` the
+// containing directory is synced as well so the rename itself survives a power failure.
+typedef enum kk_os_fsync_e {
+  KK_FSYNC_NONE,
+  KK_FSYNC_FILE,
+  KK_FSYNC_FULL
+} kk_os_fsync_t;
+
+kk_decl_export int  kk_os_write_text_file_atomic(kk_string_t path, kk_vector_t contents, kk_os_fsync_t fsync_policy, kk_context_t* ctx);
+
+// Binary files: `kk_os_write_bytes` and `kk_os_file_pwrite` take a vector of `kk_bytes_t` chunks that
+// are written using `writev` (or `pwritev`) without concatenating them first.
+kk_decl_export int  kk_os_read_bytes(kk_string_t path, kk_bytes_t* result, kk_context_t* ctx);
+kk_decl_export int  kk_os_write_bytes(kk_string_t path, kk_vector_t chunks, bool append, kk_context_t* ctx);
+
+// Open file handles for positional reads and writes; `kk_os_file_pread` returns less than `len` bytes at the end of the file.
+typedef struct kk_os_file_s kk_os_file_t;
+
+kk_decl_export int  kk_os_file_open(kk_string_t path, bool write, bool create, kk_os_file_t** file, kk_context_t* ctx);
+kk_decl_export int  kk_os_file_size(kk_os_file_t* file, int64_t* size);
+kk_decl_export int  kk_os_file_pread(kk_os_file_t* file, int64_t offset, kk_ssize_t len, kk_bytes_t* result, kk_context_t* ctx);
+kk_decl_export int  kk_os_file_pwrite(kk_os_file_t* file, int64_t offset, kk_vector_t chunks, kk_context_t* ctx);
+kk_decl_export int  kk_os_file_close(kk_os_file_t* file);
+kk_decl_export void kk_os_file_free(kk_os_file_t* file, kk_context_t* ctx);
+
 kk_decl_export int  kk_os_ensure_dir(kk_string_t dir, int mode, kk_context_t* ctx);
 kk_decl_export int  kk_os_copy_file(kk_string_t from, kk_string_t to, bool preserve_mtime, kk_context_t* ctx);
 kk_decl_export bool kk_os_is_directory(kk_string_t path, kk_context_t* ctx);
 kk_decl_export bool kk_os_is_file(kk_string_t path, kk_context_t* ctx);
 kk_decl_export int  kk_os_list_directory(kk_string_t dir, kk_vector_t* contents, kk_context_t* ctx);
 
+// Recursively iterate over all entries under a directory upto `max_depth` (in parallel, not supported on Windows yet).
+// `kk_os_walk_next` returns the next entry (or NULL at the end) and is valid until the next call.
+// At the end, `kk_os_walk_error` returns `ENOMEM` if the walk was cut short as it ran out of memory (and 0 otherwise).
+// The entry `kind` is 'd' for a directory, 'f' for a regular file, 'l' for a symbolic link, and 'o' otherwise.
+typedef struct kk_os_walk_s kk_os_walk_t;
+
+kk_decl_export int         kk_os_walk_directory(kk_string_t dir, kk_ssize_t max_depth, bool skip_hidden, kk_os_walk_t** walk, kk_context_t* ctx);
+kk_decl_export const char* kk_os_walk_next(kk_os_walk_t* walk, char* kind);
+kk_decl_export int         kk_os_walk_error(kk_os_walk_t* walk);
+kk_decl_export void        kk_os_walk_free(kk_os_walk_t* walk, kk_context_t* ctx);
+
 kk_decl_export int  kk_os_run_command(kk_string_t cmd, kk_string_t* output, kk_context_t* ctx);
 kk_decl_export int  kk_os_run_system(kk_string_t cmd, kk_context_t* ctx);
 
+// Run a program with pipes for its input and output (not supported on Windows yet).
+// `argv` is a vector of strings where the first element is the program (searched in the `PATH`).
+// `kk_os_process_read_line` sets `eof` at the end of both stdout and stderr.
+typedef struct kk_os_process_s kk_os_process_t;
+
+kk_decl_export int  kk_os_process_spawn(kk_vector_t argv, kk_string_t input, kk_os_process_t** proc, kk_context_t* ctx);
+kk_decl_export int  kk_os_process_read_line(kk_os_process_t* proc, bool* is_stderr, kk_string_t* line, bool* eof, kk_context_t* ctx);
+kk_decl_export int  kk_os_process_read_all(kk_os_process_t* proc, kk_string_t* out, kk_string_t* err, kk_context_t* ctx);
+kk_decl_export int  kk_os_process_wait(kk_os_process_t* proc, int* exitcode, kk_context_t* ctx);
+kk_decl_export void kk_os_process_free(kk_os_process_t* proc, kk_context_t* ctx);
+
 kk_decl_export kk_secs_t  kk_timer_ticks(kk_asecs_t* atto_secs, kk_context_t* ctx);
 kk_decl_export kk_asecs_t kk_timer_resolution(kk_context_t* ctx);
 
@@ -46,6 +94,21 @@ kk_decl_export kk_string_t kk_cc_name(kk_context_t* ctx);
 kk_decl_export kk_string_t kk_os_name(kk_context_t* ctx);
 kk_decl_export kk_string_t kk_cpu_arch(kk_context_t* ctx);
 kk_decl_export int         kk_cpu_count(kk_context_t* ctx);
+
+// The cpu's that this process can actually use: `available` is the minimum of the online cpu's,
+// the cpu's in the affinity mask (`sched_getaffinity`), and the cgroup (v1 or v2) CPU quota rounded up.
+typedef struct kk_cpu_info_s {
+  int host_count;      // online cpu's
+  int affinity_count;  // cpu's in the affinity mask of the process
+  int quota_count;     // cpu's allowed by the cgroup CPU quota, or 0 if there is no quota
+  int available;
+  int numa_nodes;      // number of NUMA nodes (1 if unknown)
+} kk_cpu_info_t;
+
+kk_decl_export void        kk_cpu_info(kk_cpu_info_t* info, kk_context_t* ctx);
+kk_decl_export int         kk_cpu_available(kk_context_t* ctx);
+// Store at most `max_cpus` cpu's of NUMA node `node` in `cpus`; returns the total count (or -1 if the node does not exist).
+kk_decl_export int         kk_cpu_numa_cpus(int node, int* cpus, int max_cpus);
 kk_decl_export bool        kk_cpu_is_little_endian(kk_context_t* ctx);
 
 kk_decl_export bool kk_os_set_stack_size( kk_ssize_t stack_size );
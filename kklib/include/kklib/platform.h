@@ -139,6 +139,14 @@
 #define kk_decl_export     kk_decl_externc
 #endif
 
+// Private functions of generated code; in a unity build (`koka --unity`) the program
+// and all its imports form a single translation unit and these can have internal linkage.
+#if defined(KK_UNITY_BUILD)
+#define kk_decl_private    static
+#else
+#define kk_decl_private
+#endif
+
 #if defined(__GNUC__)
 #pragma GCC diagnostic ignored "-Wunused-variable"
 #pragma GCC diagnostic ignored "-Wunused-value"
@@ -463,6 +463,16 @@ kk_decl_export kk_string_t  kk_string_trim_right(kk_string_t strs, kk_context_t*
 
 kk_decl_export kk_unit_t   kk_println(kk_string_t s, kk_context_t* ctx);
 kk_decl_export kk_unit_t   kk_print(kk_string_t s, kk_context_t* ctx);
+kk_decl_export kk_unit_t   kk_flush(kk_context_t* ctx);
+
+// Console output of `kk_print` is buffered per context and flushed when the buffer is full,
+// when a worker thread becomes idle, at the end of the program (for all threads),
+// or on every newline if `stdout` is a terminal.
+// A buffer size of 0 disables buffering (which also applies to contexts created afterwards).
+#define KK_OUTPUT_BUFFER_SIZE  (64*1024)
+kk_decl_export void        kk_output_set_buffer_size(kk_ssize_t size, kk_context_t* ctx);
+kk_decl_export void        kk_output_free(kk_context_t* ctx);
+kk_decl_export void        kk_output_done(void);
 kk_decl_export kk_unit_t   kk_trace(kk_string_t s, kk_context_t* ctx);
 kk_decl_export kk_unit_t   kk_trace_any(kk_string_t s, kk_box_t x, kk_context_t* ctx);
 kk_decl_export kk_string_t kk_show_any(kk_box_t x, kk_context_t* ctx);
@@ -15,8 +15,27 @@
 
 typedef kk_box_t  kk_promise_t;
 
+typedef enum kk_promise_status_e {
+  KK_PROMISE_OK,
+  KK_PROMISE_TIMEOUT,
+  KK_PROMISE_CANCELLED
+} kk_promise_status_t;
+
+// Wait for the result of a promise; returns `kk_box_any` if the promise was cancelled (use `kk_promise_wait` to distinguish).
 kk_decl_export kk_box_t     kk_promise_get( kk_promise_t pr, kk_context_t* ctx );
 
+// Wait at most `timeout` milli-seconds (or indefinitely if negative) for the result of a promise.
+// The `result` is only set if `KK_PROMISE_OK` is returned. When waiting indefinitely inside a task
+// group, other queued tasks of the group are run in the meantime; with a timeout we only block.
+kk_decl_export kk_promise_status_t kk_promise_wait( kk_promise_t pr, kk_msecs_t timeout, kk_box_t* result, kk_context_t* ctx );
+
+// Wait for the first available result of a vector of promises and set its `index`. Cancelled promises are
+// skipped, and `KK_PROMISE_CANCELLED` is returned if all promises are cancelled.
+kk_decl_export kk_promise_status_t kk_promise_wait_any( kk_vector_t promises, kk_msecs_t timeout, kk_ssize_t* index, kk_box_t* result, kk_context_t* ctx );
+
+// Cancel a promise: if its task is still queued it is not run, and any waiters are woken up.
+kk_decl_export void         kk_promise_cancel( kk_promise_t pr, kk_context_t* ctx );
+
 /*--------------------------------------------------------------------------------------
    Tasks
 --------------------------------------------------------------------------------------*/
@@ -25,6 +44,35 @@ kk_decl_export kk_promise_t kk_task_schedule( kk_function_t fun, kk_context_t* c
 // kk_decl_export kk_promise_t kk_task_schedule_n( kk_ssize_t count, kk_ssize_t stride, kk_function_t fun, kk_function_t combine, kk_context_t* ctx );
 
 kk_decl_export void kk_task_set_default_concurrency(kk_ssize_t thread_count, kk_context_t* ctx);
+
+// Place workers per NUMA node (pinned to the cpu's of their node) with a task queue per node.
+// Only has effect if called before the first task is scheduled (or use the `--kknuma` option).
+kk_decl_export void kk_task_set_numa_aware(bool enable, kk_context_t* ctx);
+
+// Runtime statistics of the task workers; the counts are 0 if no task was scheduled yet.
+typedef struct kk_task_stats_s {
+  kk_cpu_info_t cpu;           // detected cpu's (see `kk_cpu_info`)
+  kk_ssize_t    thread_count;  // number of worker threads
+  kk_ssize_t    queue_count;   // number of task queues (the NUMA nodes used, or 1)
+  kk_ssize_t    queued;        // tasks currently waiting in the queues
+  kk_ssize_t    tasks_run;     // tasks run so far by the workers
+} kk_task_stats_t;
+
+kk_decl_export void kk_task_stats(kk_task_stats_t* stats, kk_context_t* ctx);
+
+/*--------------------------------------------------------------------------------------
+   Task scopes
+   Tasks started in a scope are cancelled together by `kk_task_scope_cancel`; cancellation
+   is checked when a task is dequeued and while waiting on its promise (running tasks are
+   not interrupted but can poll `kk_task_scope_is_cancelled`).
+--------------------------------------------------------------------------------------*/
+
+typedef kk_box_t kk_task_scope_t;
+
+kk_decl_export kk_task_scope_t kk_task_scope_alloc( kk_context_t* ctx );
+kk_decl_export kk_promise_t    kk_task_schedule_in( kk_task_scope_t scope, kk_function_t fun, kk_context_t* ctx );
+kk_decl_export void            kk_task_scope_cancel( kk_task_scope_t scope, kk_context_t* ctx );
+kk_decl_export bool            kk_task_scope_is_cancelled( kk_task_scope_t scope, kk_context_t* ctx );
 // kk_decl_export void kk_task_group_free( kk_task_group_t* tg, kk_context_t* ctx );
 
 /*--------------------------------------------------------------------------------------
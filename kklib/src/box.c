@@ -272,104 +272,18 @@ typedef struct kk_boxed_double_s {
   double  value;
 } *kk_boxed_double_t;
 
-static double kk_double_unbox_heap(kk_box_t b, kk_context_t* ctx) {
+double kk_double_unbox_heap(kk_box_t b, kk_context_t* ctx) {
   kk_boxed_double_t dt = kk_block_assert(kk_boxed_double_t, kk_ptr_unbox(b), KK_TAG_DOUBLE);
   double d = dt->value;
   if (ctx != NULL) { kk_basetype_drop(dt, ctx); }
   return d;
 }
 
-static kk_box_t kk_double_box_heap(double d, kk_context_t* ctx) {
+kk_box_t kk_double_box_heap(double d, kk_context_t* ctx) {
   kk_boxed_double_t dt = kk_block_alloc_as(struct kk_boxed_double_s, 0, KK_TAG_DOUBLE, ctx);
   dt->value = d;
   return kk_ptr_box(&dt->_block);
 }
-
-
-#if (KK_BOX_DOUBLE64 == 2)  // heap allocate when negative
-kk_box_t kk_double_box(double d, kk_context_t* ctx) {
-  kk_unused(ctx);
-  uint64_t i = kk_bits_from_double(d);
-  //if (isnan(d)) { kk_debugger_break(ctx); }
-  if ((int64_t)i >= 0) {  // positive?
-    kk_box_t b = { ((uintptr_t)i<<1)|1 };
-    return b;
-  }
-  else {
-    // heap allocate
-    return kk_double_box_heap(d, ctx);
-  }
-}
-
-double kk_double_unbox(kk_box_t b, kk_context_t* ctx) {
-  kk_unused(ctx);
-  double d;
-  if (kk_box_is_value(b)) {
-    // positive double
-    uint64_t u = kk_shrp(b.box, 1);
-    d = kk_bits_to_double(u);
-  }
-  else {
-    // heap allocated
-    d = kk_double_unbox_heap(b, ctx);
-  }
-  // if (isnan(d)) { kk_debugger_break(ctx); }
-  return d;
-}
-#else  // heap allocate when the exponent is between 0x200 and 0x5FF.
-kk_box_t kk_double_box(double d, kk_context_t* ctx) {
-  kk_unused(ctx);
-  uint64_t u = kk_bits_from_double(d);
-  u = kk_bits_rotl64(u, 12);
-  uint64_t exp = u & 0x7FF;
-  u -= exp;
-  // adjust to 10-bit exponent (if possible)
-  if (exp==0) { // zero or subnormal
-    // already good
-  }
-  else if (exp==0x7FF) { // infinity or NaN
-    exp = 0x3FF;
-  }
-  else if (exp > 0x200 && exp < 0x5FF) {  // absolute value between [2^-510,2^512)
-    exp -= 0x200;
-  }
-  else {
-    // outside our range, heap allocate (outside [2^-510,2^512) and not 0, subnormal, NaN or Inf)
-    return kk_double_box_heap(d, ctx);
-  }
-  kk_assert_internal(exp <= 0x3FF);
-  kk_box_t b = { (u | (exp<<1) | 1) };
-  return b;
-}
-
-double kk_double_unbox(kk_box_t b, kk_context_t* ctx) {
-  kk_unused(ctx);
-  if (kk_box_is_value(b)) {
-    // expand 10-bit exponent to 11-bits again
-    uint64_t u = b.box;
-    uint64_t exp = u & 0x7FF;
-    u -= exp;    // clear lower 11 bits
-    exp >>= 1;
-    if (exp == 0) {
-      // ok
-    }
-    else if (exp==0x3FF) {
-      exp = 0x7FF;
-    }
-    else {
-      exp += 0x200;
-    }
-    kk_assert_internal(exp <= 0x7FF);
-    u = kk_bits_rotr64(u | exp, 12);
-    double d = kk_bits_to_double(u);
-    return d;
-  }
-  else {
-    // heap allocated
-    return kk_double_unbox_heap(b, ctx);
-  }
-}
-#endif
 #endif
 
 
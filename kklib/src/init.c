@@ -141,6 +141,7 @@ static bool process_initialized; // = false
 static void kklib_done(void) {
   if (!process_initialized) return;
   kk_free_context();
+  kk_output_done();  // flush the console output of all threads
   process_initialized = false;
 }
 
@@ -214,6 +215,7 @@ kk_context_t* kk_get_context(void) {
 
 void kk_free_context(void) {
   if (context != NULL) {
+    kk_output_free(context);
     kk_block_drop(context->evv, context);
     kk_basetype_free(context->kk_box_any,context);
     // kk_basetype_drop_assert(context->kk_box_any, KK_TAG_BOX_ANY, context);
@@ -229,6 +231,88 @@ void kk_free_context(void) {
   }
 }
 
+/*--------------------------------------------------------------------------------------------------
+  Effect handler profiling (enabled with the --kkprofile option)
+--------------------------------------------------------------------------------------------------*/
+
+typedef struct kk_prof_entry_s {
+  char*       tag;                      // handler tag name (owned)
+  int64_t     counts[KK_PROF_EVENTS];
+} kk_prof_entry_t;
+
+typedef struct kk_prof_s {
+  kk_ssize_t       count;
+  kk_ssize_t       capacity;
+  kk_prof_entry_t* entries;
+  kk_ssize_t       last;                // index of the last used entry (as events usually repeat for the same tag)
+} kk_prof_t;
+
+static kk_prof_entry_t* kk_prof_entry(kk_prof_t* prof, const char* tag, kk_context_t* ctx) {
+  if (prof->last < prof->count && strcmp(prof->entries[prof->last].tag, tag) == 0) {
+    return &prof->entries[prof->last];
+  }
+  for (kk_ssize_t i = 0; i < prof->count; i++) {
+    if (strcmp(prof->entries[i].tag, tag) == 0) {
+      prof->last = i;
+      return &prof->entries[i];
+    }
+  }
+  if (prof->count >= prof->capacity) {
+    prof->capacity = (prof->capacity == 0 ? 16 : 2*prof->capacity);
+    prof->entries = (kk_prof_entry_t*)kk_realloc(prof->entries, prof->capacity * kk_ssizeof(kk_prof_entry_t), ctx);
+  }
+  kk_prof_entry_t* entry = &prof->entries[prof->count];
+  memset(entry, 0, sizeof(kk_prof_entry_t));
+  const kk_ssize_t len = kk_sstrlen(tag);
+  entry->tag = (char*)kk_malloc(len + 1, ctx);
+  kk_memcpy(entry->tag, tag, len + 1);
+  prof->last = prof->count++;
+  return entry;
+}
+
+void kk_prof_count(const char* tag, kk_prof_event_t event, kk_context_t* ctx) {
+  if (ctx->prof == NULL || (unsigned)event >= (unsigned)KK_PROF_EVENTS) return;
+  kk_prof_entry_t* entry = kk_prof_entry(ctx->prof, (tag == NULL || tag[0] == 0 ? "<unknown>" : tag), ctx);
+  entry->counts[event]++;
+}
+
+static int64_t kk_prof_total(const kk_prof_entry_t* entry) {
+  int64_t total = 0;
+  for (int i = 0; i < KK_PROF_EVENTS; i++) { total += entry->counts[i]; }
+  return total;
+}
+
+static int kk_prof_entry_cmp(const void* p1, const void* p2) {
+  const int64_t total1 = kk_prof_total((const kk_prof_entry_t*)p1);
+  const int64_t total2 = kk_prof_total((const kk_prof_entry_t*)p2);
+  return (total1 > total2 ? -1 : (total1 < total2 ? 1 : 0));
+}
+
+static void kk_prof_start(kk_context_t* ctx) {
+  if (ctx->prof != NULL) return;
+  ctx->prof = (kk_prof_t*)kk_zalloc(kk_ssizeof(kk_prof_t), ctx);
+}
+
+// print the profile sorted on the total event count and release it
+static void kk_prof_done(kk_context_t* ctx) {
+  kk_prof_t* prof = ctx->prof;
+  if (prof == NULL) return;
+  ctx->prof = NULL;
+  qsort(prof->entries, kk_to_size_t(prof->count), sizeof(kk_prof_entry_t), &kk_prof_entry_cmp);
+  kk_info_message("%-32s %12s %12s %12s %12s %12s %12s\n", "effect", "operations", "yields", "extends", "composes", "lookups", "evv-allocs");
+  for (kk_ssize_t i = 0; i < prof->count; i++) {
+    const kk_prof_entry_t* entry = &prof->entries[i];
+    kk_info_message("%-32s %12lld %12lld %12lld %12lld %12lld %12lld\n", entry->tag,
+                    (long long)entry->counts[KK_PROF_OPERATION], (long long)entry->counts[KK_PROF_YIELD],
+                    (long long)entry->counts[KK_PROF_EXTEND], (long long)entry->counts[KK_PROF_COMPOSE],
+                    (long long)entry->counts[KK_PROF_LOOKUP], (long long)entry->counts[KK_PROF_EVV_ALLOC]);
+    kk_free(entry->tag, ctx);
+  }
+  kk_free(prof->entries, ctx);
+  kk_free(prof, ctx);
+}
+
+
 /*--------------------------------------------------------------------------------------------------
   Called from main
 --------------------------------------------------------------------------------------------------*/
@@ -243,6 +327,15 @@ kk_decl_export kk_context_t* kk_main_start(int argc, char** argv) {
       if (strcmp(arg, "--kktime")==0) {
         ctx->process_start = kk_timer_start();
       }
+      else if (strcmp(arg, "--kkprofile")==0) {
+        kk_prof_start(ctx);
+      }
+      else if (strcmp(arg, "--kknuma")==0) {  // NUMA aware task workers
+        kk_task_set_numa_aware(true, ctx);
+      }
+      else if (strncmp(arg, "--kkoutbuf=", 11)==0) {  // console output buffer size in KiB (0 for unbuffered)
+        kk_output_set_buffer_size(1024 * (kk_ssize_t)atol(arg + 11), ctx);
+      }
       else {
         break;
       }
@@ -258,6 +351,7 @@ kk_decl_export kk_context_t* kk_main_start(int argc, char** argv) {
 }
 
 kk_decl_export void  kk_main_end(kk_context_t* ctx) {
+  kk_flush(ctx);
   if (ctx->process_start != 0) {  // started with --kktime option
     kk_usecs_t wall_time = kk_timer_end(ctx->process_start);
     kk_msecs_t user_time;
@@ -273,6 +367,7 @@ kk_decl_export void  kk_main_end(kk_context_t* ctx) {
                     (peak_rss > 10*1024*1024 ? peak_rss/(1024*1024) : peak_rss/1024),
                     (peak_rss > 10*1024*1024 ? "mb" : "kb") );
   }
+  kk_prof_done(ctx);
 }
 
 
@@ -275,11 +275,24 @@ static kk_bigint_t* kk_bigint_trim(kk_bigint_t* x, bool allow_realloc, kk_contex
   return kk_bigint_trim_to(x, i, allow_realloc, ctx);
 }
 
+// Allocate a bigint with some extra digits available beyond `count`. This is used
+// when a result outgrows its argument so that accumulation loops (like `acc + x`)
+// can update the result in-place afterwards instead of allocating at each carry.
+static kk_bigint_t* bigint_alloc_slack(kk_ssize_t count, bool is_neg, kk_context_t* ctx) {
+  kk_ssize_t slack = 2 + (count/8);
+  if (slack > MAX_EXTRA) slack = MAX_EXTRA;
+  kk_bigint_t* b = bigint_alloc(count + slack, is_neg, ctx);
+  return kk_bigint_trim_to(b, count, false /* no realloc */, ctx);
+}
+
 static kk_bigint_t* bigint_alloc_reuse_(kk_bigint_t* x, kk_ssize_t count, kk_context_t* ctx) {
   kk_ssize_t d = (bigint_available_(x) - count);
   if (d >= 0 && d <= MAX_EXTRA && bigint_is_unique_(x)) {   // reuse?
     return kk_bigint_trim_to(x, count, false /* no realloc */, ctx);
   }
+  else if (d < 0) {  // growing: reserve extra space for the next time
+    return bigint_alloc_slack(count, bigint_is_neg_(x), ctx);
+  }
   else {
     return bigint_alloc(count, bigint_is_neg_(x), ctx);
   }
@@ -947,6 +960,54 @@ static kk_bigint_t* kk_bigint_sub_abs(kk_bigint_t* x, kk_bigint_t* y, kk_context
   return kk_bigint_trim(z,true,ctx);
 }
 
+static kk_bigint_t* kk_bigint_sub_abs_small(kk_bigint_t* x, kk_digit_t y, kk_context_t* ctx) {  // |x| >= y
+  kk_assert_internal(y < BASE);
+  const kk_ssize_t cx = bigint_count_(x);
+  kk_assert_internal(cx > 1 || (cx == 1 && x->digits[0] >= y));
+  kk_bigint_t* z = bigint_alloc_reuse_(x, cx, ctx); // if z==x, we reused x.
+  kk_digit_t borrow = y;
+  kk_digit_t diff = 0;
+  // subtract y from the digits of x
+  kk_ssize_t i;
+  for (i = 0; borrow != 0 && i < cx; i++) {
+    diff = x->digits[i] - borrow;
+    if (kk_unlikely(diff >= BASE)) {  // unsigned wrap around
+      borrow = 1;
+      diff += BASE;
+      kk_assert_internal(diff < BASE);
+    }
+    else {
+      borrow = 0;
+    }
+    z->digits[i] = diff;
+  }
+  kk_assert_internal(borrow==0);  // since |x| >= y
+  // copy the tail
+  if (z != x) {
+    for (; i < cx; i++) {
+      z->digits[i] = x->digits[i];
+    }
+    drop_bigint(x, ctx);
+  }
+  return kk_bigint_trim(z, true, ctx);
+}
+
+// Add a small integer `y` (with `|y| < BASE`) to a bigint `x` of at least 2 digits
+// (so `|x| > |y|` and the sign of the result is the sign of `x`).
+// This avoids allocating a temporary bigint for `y` and updates `x` in-place if it is unique.
+static kk_bigint_t* bigint_add_small(kk_bigint_t* x, kk_intx_t y, kk_context_t* ctx) {
+  kk_assert_internal(bigint_count_(x) > 1);
+  kk_assert_internal(y > -BASE && y < BASE);
+  const bool yneg = (y < 0);
+  const kk_digit_t ay = (kk_digit_t)(yneg ? -y : y);
+  if (bigint_is_neg_(x) == yneg) {
+    return kk_bigint_add_abs_small(x, ay, ctx);
+  }
+  else {
+    return kk_bigint_sub_abs_small(x, ay, ctx);
+  }
+}
+
 /*----------------------------------------------------------------------
   Multiply & Sqr. including Karatsuba multiplication
 ----------------------------------------------------------------------*/
@@ -1288,8 +1349,26 @@ int kk_integer_cmp_generic_borrow(kk_integer_t x, kk_integer_t y, kk_context_t*
   return kk_integer_cmp_generic(kk_integer_dup(x), kk_integer_dup(y), ctx);
 }
 
+// Is `x` a bigint of at least 2 digits, and `y` a small int that fits in a digit?
+// In that case we can use the `_small` operations that update `x` in-place (if unique)
+// instead of converting `y` to a temporary bigint. This is the common case in
+// accumulation loops like `acc + 1` or `acc * 3`.
+static bool integer_is_big_small(kk_integer_t x, kk_integer_t y) {
+  if (!kk_is_bigint(x) || !kk_is_smallint(y)) return false;
+  const kk_intx_t i = kk_smallint_from_integer(y);
+  if (i <= -BASE || i >= BASE) return false;
+  const kk_bigint_t* bx = kk_block_assert(kk_bigint_t*, _kk_integer_ptr(x), KK_TAG_BIGINT);
+  return (bigint_count_(bx) > 1);
+}
+
 kk_integer_t kk_integer_add_generic(kk_integer_t x, kk_integer_t y, kk_context_t* ctx) {
   kk_assert_internal(kk_is_integer(x)&&kk_is_integer(y));
+  if (integer_is_big_small(x, y)) {
+    return integer_bigint(bigint_add_small(kk_integer_to_bigint(x, ctx), kk_smallint_from_integer(y), ctx), ctx);
+  }
+  else if (integer_is_big_small(y, x)) {
+    return integer_bigint(bigint_add_small(kk_integer_to_bigint(y, ctx), kk_smallint_from_integer(x), ctx), ctx);
+  }
   kk_bigint_t* bx = kk_integer_to_bigint(x, ctx);
   kk_bigint_t* by = kk_integer_to_bigint(y, ctx);
   return integer_bigint(bigint_add(bx, by, by->is_neg, ctx), ctx);
@@ -1297,6 +1376,13 @@ kk_integer_t kk_integer_add_generic(kk_integer_t x, kk_integer_t y, kk_context_t
 
 kk_integer_t kk_integer_sub_generic(kk_integer_t x, kk_integer_t y, kk_context_t* ctx) {
   kk_assert_internal(kk_is_integer(x)&&kk_is_integer(y));
+  if (integer_is_big_small(x, y)) {
+    return integer_bigint(bigint_add_small(kk_integer_to_bigint(x, ctx), -kk_smallint_from_integer(y), ctx), ctx);
+  }
+  else if (integer_is_big_small(y, x)) {
+    kk_bigint_t* z = bigint_add_small(kk_integer_to_bigint(y, ctx), -kk_smallint_from_integer(x), ctx);
+    return integer_bigint(bigint_neg(z, ctx), ctx);
+  }
   kk_bigint_t* bx = kk_integer_to_bigint(x, ctx);
   kk_bigint_t* by = kk_integer_to_bigint(y, ctx);
   return integer_bigint(kk_bigint_sub(bx, by, by->is_neg, ctx), ctx);
@@ -1306,8 +1392,24 @@ static bool use_karatsuba(kk_ssize_t i, kk_ssize_t j) {
   return ((0.000012*(double)(i*j) - 0.0025*(double)(i+j)) >= 0.0);
 }
 
+static kk_integer_t integer_mul_big_small(kk_integer_t x, kk_intx_t y, kk_context_t* ctx) {
+  if (y == 0) {
+    kk_integer_drop(x, ctx);
+    return kk_integer_zero;
+  }
+  kk_bigint_t* z = kk_bigint_mul_small(kk_integer_to_bigint(x, ctx), (kk_digit_t)(y < 0 ? -y : y), ctx);
+  if (y < 0) { z = bigint_neg(z, ctx); }
+  return integer_bigint(z, ctx);
+}
+
 kk_integer_t kk_integer_mul_generic(kk_integer_t x, kk_integer_t y, kk_context_t* ctx) {
   kk_assert_internal(kk_is_integer(x)&&kk_is_integer(y));
+  if (integer_is_big_small(x, y)) {
+    return integer_mul_big_small(x, kk_smallint_from_integer(y), ctx);
+  }
+  else if (integer_is_big_small(y, x)) {
+    return integer_mul_big_small(y, kk_smallint_from_integer(x), ctx);
+  }
   kk_bigint_t* bx = kk_integer_to_bigint(x, ctx);
   kk_bigint_t* by = kk_integer_to_bigint(y, ctx);
   bool usek = use_karatsuba(bx->count, by->count);
@@ -28,6 +28,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <fcntl.h>
 #endif
@@ -240,12 +241,357 @@ kk_decl_export int kk_os_write_text_file(kk_string_t path, kk_string_t content,
 
 
 
+/*--------------------------------------------------------------------------------------------------
+  Binary files
+--------------------------------------------------------------------------------------------------*/
+
+#define KK_IOV_BATCH  (64)   // number of chunks passed to a single `writev`
+
+// Write a (borrowed) vector of `kk_bytes_t` chunks to `out` at `offset` (or at the current position if `offset < 0`).
+// On posix systems the chunks are written in batches using `writev` (or `pwritev`) to avoid concatenation.
+static int kk_posix_write_chunks(const kk_file_t out, kk_vector_t chunks, int64_t offset) {
+  kk_ssize_t n;
+  kk_box_t* elems = kk_vector_buf_borrow(chunks, &n);
+#if defined(WIN32)
+  if (offset >= 0 && _lseeki64(out, offset, SEEK_SET) < 0) return errno;
+  for (kk_ssize_t i = 0; i < n; i++) {
+    kk_ssize_t len;
+    const uint8_t* buf = kk_bytes_buf_borrow(kk_bytes_unbox(elems[i]), &len);
+    if (len > 0) {
+      int err = kk_posix_write_retry(out, buf, len, NULL);
+      if (err != 0) return err;
+    }
+  }
+  return 0;
+#else
+  struct iovec iov[KK_IOV_BATCH];
+  kk_ssize_t i = 0;
+  while (i < n) {
+    // fill a batch (skipping empty chunks)
+    int count = 0;
+    for (; i < n && count < KK_IOV_BATCH; i++) {
+      kk_ssize_t len;
+      const uint8_t* buf = kk_bytes_buf_borrow(kk_bytes_unbox(elems[i]), &len);
+      if (len > 0) {
+        iov[count].iov_base = (void*)buf;
+        iov[count].iov_len = (size_t)len;
+        count++;
+      }
+    }
+    // and write it, resuming after partial writes
+    struct iovec* cur = iov;
+    while (count > 0) {
+      ssize_t w;
+      if (offset < 0) {
+        w = writev(out, cur, count);
+      }
+      else {
+        #if defined(__linux__) || defined(__FreeBSD__)
+        w = pwritev(out, cur, count, (off_t)offset);
+        #else
+        w = pwrite(out, cur->iov_base, cur->iov_len, (off_t)offset);
+        #endif
+      }
+      if (w < 0) {
+        if (errno != EAGAIN && errno != EINTR) return errno;
+        continue;  // otherwise try again
+      }
+      else if (w == 0) {  // treat as error to ensure progress
+        return EIO;
+      }
+      if (offset >= 0) offset += w;
+      size_t written = (size_t)w;
+      while (count > 0 && written >= cur->iov_len) {
+        written -= cur->iov_len;
+        cur++;
+        count--;
+      }
+      if (count > 0) {
+        cur->iov_base = (uint8_t*)cur->iov_base + written;
+        cur->iov_len -= written;
+      }
+    }
+  }
+  return 0;
+#endif
+}
+
+kk_decl_export int kk_os_read_bytes(kk_string_t path, kk_bytes_t* result, kk_context_t* ctx)
+{
+  *result = kk_bytes_empty();
+  kk_file_t f;
+  int err = kk_posix_open(path, O_RDONLY, 0, &f, ctx);
+  if (err != 0) return err;
+
+  kk_ssize_t len;
+  err = kk_posix_fsize(f, &len);
+  if (err != 0) {
+    kk_posix_close(f);
+    return err;
+  }
+  uint8_t* cbuf;
+  kk_bytes_t buf = kk_bytes_alloc_buf(len, &cbuf, ctx);
+
+  kk_ssize_t nread;
+  err = kk_posix_read_retry(f, cbuf, len, &nread);
+  kk_posix_close(f);
+  if (err != 0) {
+    kk_bytes_drop(buf, ctx);
+    return err;
+  }
+  if (nread < len) {
+    buf = kk_bytes_adjust_length(buf, nread, ctx);
+  }
+  *result = buf;
+  return 0;
+}
+
+kk_decl_export int kk_os_write_bytes(kk_string_t path, kk_vector_t chunks, bool append, kk_context_t* ctx)
+{
+  kk_file_t f;
+  int err = kk_posix_open(path, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644, &f, ctx);
+  if (err != 0) {
+    kk_vector_drop(chunks, ctx);
+    return err;
+  }
+  err = kk_posix_write_chunks(f, chunks, -1);
+  kk_vector_drop(chunks, ctx);
+  const int cerr = kk_posix_close(f);
+  return (err != 0 ? err : cerr);
+}
+
+struct kk_os_file_s {
+  kk_file_t fd;
+  bool      closed;
+};
+
+kk_decl_export int kk_os_file_open(kk_string_t path, bool write, bool create, kk_os_file_t** file, kk_context_t* ctx)
+{
+  *file = NULL;
+  int flags = (write ? O_RDWR : O_RDONLY) | (write && create ? O_CREAT : 0);
+  #if defined(WIN32)
+  flags |= O_BINARY;
+  #endif
+  kk_file_t f;
+  int err = kk_posix_open(path, flags, 0644, &f, ctx);
+  if (err != 0) return err;
+  kk_os_file_t* fh = (kk_os_file_t*)kk_malloc(kk_ssizeof(kk_os_file_t), ctx);
+  if (fh == NULL) {
+    kk_posix_close(f);
+    return ENOMEM;
+  }
+  fh->fd = f;
+  fh->closed = false;
+  *file = fh;
+  return 0;
+}
+
+kk_decl_export int kk_os_file_size(kk_os_file_t* file, int64_t* size)
+{
+  *size = 0;
+  if (file->closed) return EBADF;
+  kk_stat_t st;
+  int err = kk_posix_fstat(file->fd, &st);
+  if (err != 0) return err;
+  *size = (int64_t)st.st_size;
+  return 0;
+}
+
+kk_decl_export int kk_os_file_pread(kk_os_file_t* file, int64_t offset, kk_ssize_t len, kk_bytes_t* result, kk_context_t* ctx)
+{
+  *result = kk_bytes_empty();
+  if (file->closed) return EBADF;
+  if (offset < 0 || len < 0) return EINVAL;
+  if (len == 0) return 0;
+  uint8_t* cbuf;
+  kk_bytes_t buf = kk_bytes_alloc_buf(len, &cbuf, ctx);
+  int err = 0;
+  kk_ssize_t nread = 0;
+#if defined(WIN32)
+  if (_lseeki64(file->fd, offset, SEEK_SET) < 0) err = errno;
+  if (err == 0) err = kk_posix_read_retry(file->fd, cbuf, len, &nread);
+#else
+  while (nread < len) {
+    const ssize_t n = pread(file->fd, cbuf + nread, (size_t)(len - nread), (off_t)(offset + nread));
+    if (n < 0) {
+      if (errno != EAGAIN && errno != EINTR) {
+        err = errno;
+        break;
+      }
+      // otherwise try again
+    }
+    else if (n == 0) {  // eof
+      break;
+    }
+    else {
+      nread += n;
+    }
+  }
+#endif
+  if (err != 0) {
+    kk_bytes_drop(buf, ctx);
+    return err;
+  }
+  if (nread < len) {
+    buf = kk_bytes_adjust_length(buf, nread, ctx);
+  }
+  *result = buf;
+  return 0;
+}
+
+kk_decl_export int kk_os_file_pwrite(kk_os_file_t* file, int64_t offset, kk_vector_t chunks, kk_context_t* ctx)
+{
+  int err;
+  if (file->closed) err = EBADF;
+  else if (offset < 0) err = EINVAL;
+  else err = kk_posix_write_chunks(file->fd, chunks, offset);
+  kk_vector_drop(chunks, ctx);
+  return err;
+}
+
+kk_decl_export int kk_os_file_close(kk_os_file_t* file)
+{
+  if (file->closed) return 0;
+  file->closed = true;
+  return kk_posix_close(file->fd);
+}
+
+kk_decl_export void kk_os_file_free(kk_os_file_t* file, kk_context_t* ctx)
+{
+  if (file == NULL) return;
+  kk_os_file_close(file);
+  kk_free(file, ctx);
+}
+
+
+/*--------------------------------------------------------------------------------------------------
+  Atomic writes
+--------------------------------------------------------------------------------------------------*/
+
+static int kk_posix_fsync(kk_file_t f, bool full) {
+#if defined(WIN32)
+  kk_unused(full);
+  return (_commit(f) < 0 ? errno : 0);
+#elif defined(__APPLE__)
+  if (full && fcntl(f, F_FULLFSYNC) == 0) return 0;  // fsync on macOS does not flush the drive cache
+  return (fsync(f) < 0 ? errno : 0);
+#elif defined(__linux__)
+  return ((full ? fsync(f) : fdatasync(f)) < 0 ? errno : 0);
+#else
+  kk_unused(full);
+  return (fsync(f) < 0 ? errno : 0);
+#endif
+}
+
+#if defined(WIN32)
+#include <Windows.h>
+static int kk_os_write_atomic_at(const wchar_t* wpath, kk_vector_t chunks, kk_os_fsync_t fsync_policy, kk_context_t* ctx) {
+  const size_t plen = wcslen(wpath);
+  wchar_t* wtemp = (wchar_t*)kk_malloc((kk_ssize_t)((plen + 5) * sizeof(wchar_t)), ctx);
+  if (wtemp == NULL) return ENOMEM;
+  memcpy(wtemp, wpath, plen * sizeof(wchar_t));
+  memcpy(wtemp + plen, L".tmp", 5 * sizeof(wchar_t));
+  int err = 0;
+  const kk_file_t f = _wopen(wtemp, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+  if (f < 0) {
+    err = errno;
+  }
+  else {
+    err = kk_posix_write_chunks(f, chunks, -1);
+    if (err == 0 && fsync_policy != KK_FSYNC_NONE) err = kk_posix_fsync(f, fsync_policy == KK_FSYNC_FULL);
+    const int cerr = kk_posix_close(f);
+    if (err == 0) err = cerr;
+    if (err == 0) {
+      const DWORD flags = MOVEFILE_REPLACE_EXISTING | (fsync_policy == KK_FSYNC_FULL ? MOVEFILE_WRITE_THROUGH : 0);
+      if (!MoveFileExW(wtemp, wpath, flags)) err = (GetLastError() == ERROR_ACCESS_DENIED ? EACCES : EIO);
+    }
+    if (err != 0) _wunlink(wtemp);
+  }
+  kk_free(wtemp, ctx);
+  return err;
+}
+#else
+// Sync the directory containing `path` so a preceding `rename` is durable.
+static int kk_posix_fsync_dir(const char* path, kk_context_t* ctx) {
+  const char* sep = strrchr(path, '/');
+  const size_t dlen = (sep == NULL ? 0 : (sep == path ? 1 : (size_t)(sep - path)));
+  char* dir = (char*)kk_malloc((kk_ssize_t)(dlen + 2), ctx);
+  if (dir == NULL) return ENOMEM;
+  if (dlen == 0) { dir[0] = '.'; dir[1] = 0; }
+            else { memcpy(dir, path, dlen); dir[dlen] = 0; }
+  int err = 0;
+  const int fd = open(dir, O_RDONLY);
+  if (fd < 0) {
+    err = errno;
+  }
+  else {
+    if (fsync(fd) < 0 && errno != EINVAL) err = errno;  // some file systems do not support syncing directories
+    close(fd);
+  }
+  kk_free(dir, ctx);
+  return err;
+}
+
+static int kk_os_write_atomic_at(const char* cpath, kk_vector_t chunks, kk_os_fsync_t fsync_policy, kk_context_t* ctx) {
+  // create a unique temporary file in the same directory so the final `rename` is atomic
+  const size_t plen = strlen(cpath);
+  char* ctemp = (char*)kk_malloc((kk_ssize_t)(plen + 8), ctx);
+  if (ctemp == NULL) return ENOMEM;
+  memcpy(ctemp, cpath, plen);
+  memcpy(ctemp + plen, ".XXXXXX", 8);
+  int err = 0;
+  const kk_file_t f = mkstemp(ctemp);
+  if (f < 0) {
+    err = errno;
+  }
+  else {
+    // keep the mode of an existing file (`mkstemp` creates the file with mode 0600)
+    struct stat st;
+    const mode_t mode = (stat(cpath, &st) == 0 ? (st.st_mode & 07777) : 0644);
+    if (fchmod(f, mode) < 0) err = errno;
+    if (err == 0) err = kk_posix_write_chunks(f, chunks, -1);
+    if (err == 0 && fsync_policy != KK_FSYNC_NONE) err = kk_posix_fsync(f, fsync_policy == KK_FSYNC_FULL);
+    const int cerr = kk_posix_close(f);
+    if (err == 0) err = cerr;
+    if (err == 0 && rename(ctemp, cpath) < 0) err = errno;
+    if (err != 0) {
+      unlink(ctemp);
+    }
+    else if (fsync_policy == KK_FSYNC_FULL) {
+      err = kk_posix_fsync_dir(cpath, ctx);
+    }
+  }
+  kk_free(ctemp, ctx);
+  return err;
+}
+#endif
+
+kk_decl_export int kk_os_write_text_file_atomic(kk_string_t path, kk_vector_t contents, kk_os_fsync_t fsync_policy, kk_context_t* ctx)
+{
+  // strings are valid utf-8 bytes so we can write them directly as chunks
+  int err = 0;
+#if defined(WIN32)
+  kk_with_string_as_qutf16w_borrow(path, wpath, ctx) {
+    err = kk_os_write_atomic_at(wpath, contents, fsync_policy, ctx);
+  }
+#else
+  kk_with_string_as_qutf8_borrow(path, cpath, ctx) {
+    err = kk_os_write_atomic_at(cpath, contents, fsync_policy, ctx);
+  }
+#endif
+  kk_vector_drop(contents, ctx);
+  kk_string_drop(path, ctx);
+  return err;
+}
+
+
 /*--------------------------------------------------------------------------------------------------
   Read line
 --------------------------------------------------------------------------------------------------*/
 
 kk_decl_export int kk_os_read_line(kk_string_t* result, kk_context_t* ctx)
 {
+  kk_flush(ctx);  // show any prompt
   char buf[1024];
   if (fgets(buf, 1023, stdin) == NULL) return errno;
   buf[1023] = 0;      // ensure zero termination
@@ -579,6 +925,412 @@ kk_decl_export int kk_os_list_directory(kk_string_t dir, kk_vector_t* contents,
 }
 
 
+/*--------------------------------------------------------------------------------------------------
+  Walk directory: recursively iterate over all entries under a directory.
+  The entry kind is taken from `d_type` (with a `fstatat` only if the file system does not
+  provide it), entries are read in large batches with `getdents64` on Linux, and sub
+  directories are distributed over a few threads. Symbolic links are not followed.
+  The walk is streaming: each directory that is read becomes a batch of entries that the
+  caller consumes with `kk_os_walk_next`. The caller reads directories itself when no batch
+  is ready, and worker threads are only started when sub directories pile up. Workers pause
+  when too many batches are waiting so memory stays bounded for a slow consumer.
+  Since the worker threads do not have a Koka context, batches are plain `malloc`'d buffers
+  with records of a kind byte followed by a zero terminated path.
+--------------------------------------------------------------------------------------------------*/
+
+#if defined(WIN32)
+
+kk_decl_export int kk_os_walk_directory(kk_string_t dir, kk_ssize_t max_depth, bool skip_hidden, kk_os_walk_t** walk, kk_context_t* ctx) {
+  kk_unused(max_depth); kk_unused(skip_hidden);
+  kk_string_drop(dir, ctx);
+  *walk = NULL;
+  return ENOSYS;
+}
+
+kk_decl_export const char* kk_os_walk_next(kk_os_walk_t* walk, char* kind) {
+  kk_unused(walk);
+  if (kind != NULL) *kind = 0;
+  return NULL;
+}
+
+kk_decl_export int kk_os_walk_error(kk_os_walk_t* walk) {
+  kk_unused(walk);
+  return ENOSYS;
+}
+
+kk_decl_export void kk_os_walk_free(kk_os_walk_t* walk, kk_context_t* ctx) {
+  kk_unused(walk); kk_unused(ctx);
+}
+
+#else
+#include <pthread.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#define KK_WALK_MAX_THREADS    (16)
+#define KK_WALK_SPAWN_PENDING  (4)    // start another worker if this many directories are pending
+#define KK_WALK_MAX_READY      (64)   // workers pause if this many batches are not consumed yet
+
+typedef struct kk_walk_batch_s {
+  struct kk_walk_batch_s* next;
+  uint8_t*   data;      // records: kind byte, path, 0
+  size_t     len;
+  size_t     cap;
+} kk_walk_batch_t;
+
+typedef struct kk_walk_dir_s {
+  struct kk_walk_dir_s* next;
+  kk_ssize_t            depth;
+  size_t                len;
+  char                  path[1];
+} kk_walk_dir_t;
+
+struct kk_os_walk_s {
+  pthread_mutex_t  lock;
+  pthread_cond_t   available;     // workers wait for pending directories (or room for batches)
+  pthread_cond_t   ready;         // the caller waits for batches (or pending directories)
+  kk_walk_dir_t*   pending;
+  kk_ssize_t       pending_count;
+  kk_walk_batch_t* ready_first;   // read batches in FIFO order
+  kk_walk_batch_t* ready_last;
+  kk_ssize_t       ready_count;
+  kk_ssize_t       active;        // threads (including the caller) currently reading a directory
+  kk_ssize_t       waiting;       // workers waiting for work
+  bool             stop;          // set when the walk is freed
+  bool             failed;        // out of memory
+  kk_ssize_t       max_depth;
+  bool             skip_hidden;
+  kk_ssize_t       max_workers;
+  kk_ssize_t       started;
+  pthread_t        workers[KK_WALK_MAX_THREADS];
+  // only used by the caller
+  kk_walk_batch_t* current;
+  size_t           current_ofs;
+};
+
+static bool kk_walk_batch_push(kk_walk_batch_t* b, char kind, const char* dir, size_t dirlen, const char* name, size_t namelen) {
+  const size_t needed = 1 + dirlen + 1 + namelen + 1;
+  if (b->len + needed > b->cap) {
+    size_t newcap = (b->cap < 4*1024 ? 4*1024 : 2*b->cap);
+    while (newcap < b->len + needed) newcap *= 2;
+    uint8_t* p = (uint8_t*)realloc(b->data, newcap);
+    if (p == NULL) return false;
+    b->data = p;
+    b->cap = newcap;
+  }
+  uint8_t* q = b->data + b->len;
+  *q++ = (uint8_t)kind;
+  memcpy(q, dir, dirlen); q += dirlen;
+  if (dirlen > 0 && dir[dirlen-1] != '/') *q++ = '/';
+  memcpy(q, name, namelen); q += namelen;
+  *q++ = 0;
+  b->len = (size_t)(q - b->data);
+  return true;
+}
+
+static void kk_walk_batch_free(kk_walk_batch_t* b) {
+  if (b == NULL) return;
+  free(b->data);
+  free(b);
+}
+
+static kk_walk_dir_t* kk_walk_dir_alloc(const uint8_t* path, size_t len, kk_ssize_t depth) {
+  kk_walk_dir_t* d = (kk_walk_dir_t*)malloc(sizeof(kk_walk_dir_t) + len);
+  if (d == NULL) return NULL;
+  d->next = NULL;
+  d->depth = depth;
+  d->len = len;
+  memcpy(d->path, path, len);
+  d->path[len] = 0;
+  return d;
+}
+
+static char kk_walk_kind_of_stat(int dirfd, const char* name) {
+  struct stat st;
+  if (fstatat(dirfd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) return 'o';
+  if (S_ISDIR(st.st_mode)) return 'd';
+  if (S_ISREG(st.st_mode)) return 'f';
+  if (S_ISLNK(st.st_mode)) return 'l';
+  return 'o';
+}
+
+static char kk_walk_kind_of_dtype(int dirfd, const char* name, unsigned char dtype) {
+  switch (dtype) {
+    case DT_DIR: return 'd';
+    case DT_REG: return 'f';
+    case DT_LNK: return 'l';
+    case DT_UNKNOWN: return kk_walk_kind_of_stat(dirfd, name);
+    default: return 'o';
+  }
+}
+
+// Add a directory entry to a batch (and to the local list of sub directories to visit).
+static bool kk_walk_add_entry(kk_os_walk_t* walk, kk_walk_batch_t* batch, kk_walk_dir_t* dir, int dirfd, const char* name, unsigned char dtype, kk_walk_dir_t** subdirs, kk_ssize_t* subcount) {
+  if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) return true;
+  if (name[0] == '.' && walk->skip_hidden) return true;
+  const char kind = kk_walk_kind_of_dtype(dirfd, name, dtype);
+  const size_t start = batch->len;
+  if (!kk_walk_batch_push(batch, kind, dir->path, dir->len, name, strlen(name))) return false;
+  if (kind == 'd' && dir->depth < walk->max_depth) {
+    const uint8_t* path = batch->data + start + 1;
+    kk_walk_dir_t* sub = kk_walk_dir_alloc(path, batch->len - start - 2, dir->depth + 1);
+    if (sub == NULL) return false;
+    sub->next = *subdirs;
+    *subdirs = sub;
+    (*subcount)++;
+  }
+  return true;
+}
+
+// Read all entries of a directory into a batch; returns an error code if the directory cannot be opened.
+static int kk_walk_read_dir(kk_os_walk_t* walk, kk_walk_dir_t* dir, kk_walk_batch_t* batch, kk_walk_dir_t** subdirs, kk_ssize_t* subcount) {
+  const int fd = open(dir->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) return errno;
+  int err = 0;
+#if defined(__linux__) && defined(SYS_getdents64)
+  struct kk_linux_dirent64 {
+    uint64_t       d_ino;
+    int64_t        d_off;
+    unsigned short d_reclen;
+    unsigned char  d_type;
+    char           d_name[1];
+  };
+  const size_t bufsize = 256*1024;
+  char* buf = (char*)malloc(bufsize);
+  if (buf == NULL) { close(fd); return ENOMEM; }
+  while (err == 0) {
+    const long n = syscall(SYS_getdents64, fd, buf, bufsize);
+    if (n <= 0) {
+      if (n < 0) err = errno;
+      break;
+    }
+    for (long ofs = 0; ofs < n && err == 0; ) {
+      const struct kk_linux_dirent64* entry = (const struct kk_linux_dirent64*)(buf + ofs);
+      if (!kk_walk_add_entry(walk, batch, dir, fd, entry->d_name, entry->d_type, subdirs, subcount)) err = ENOMEM;
+      ofs += entry->d_reclen;
+    }
+  }
+  free(buf);
+  close(fd);
+#else
+  DIR* d = fdopendir(fd);
+  if (d == NULL) { err = errno; close(fd); return err; }
+  struct dirent* entry;
+  while (err == 0 && (entry = readdir(d)) != NULL) {
+    #if defined(DT_UNKNOWN)
+    const unsigned char dtype = entry->d_type;
+    #else
+    const unsigned char dtype = 0;
+    #endif
+    if (!kk_walk_add_entry(walk, batch, dir, dirfd(d), entry->d_name, dtype, subdirs, subcount)) err = ENOMEM;
+  }
+  closedir(d);  // also closes fd
+#endif
+  return err;
+}
+
+static void* kk_walk_worker(void* arg);
+
+// Read a pending directory `dir` (taken from the queue while holding the lock) and return its batch.
+// Called without holding the lock; returns with the lock held after sharing the sub directories.
+// Workers are started lazily when the pending directories pile up and no worker is waiting.
+static kk_walk_batch_t* kk_walk_step(kk_os_walk_t* walk, kk_walk_dir_t* dir) {
+  kk_walk_batch_t* batch = (kk_walk_batch_t*)calloc(1, sizeof(kk_walk_batch_t));
+  kk_walk_dir_t* subdirs = NULL;
+  kk_ssize_t subcount = 0;
+  // read it (and ignore directories we cannot read)
+  if (batch != NULL && kk_walk_read_dir(walk, dir, batch, &subdirs, &subcount) == ENOMEM) {
+    kk_walk_batch_free(batch);
+    batch = NULL;
+  }
+  free(dir);
+  pthread_mutex_lock(&walk->lock);
+  if (batch == NULL) walk->failed = true;
+  if (subdirs != NULL) {
+    kk_walk_dir_t* last = subdirs;
+    while (last->next != NULL) { last = last->next; }
+    last->next = walk->pending;
+    walk->pending = subdirs;
+    walk->pending_count += subcount;
+    if (walk->waiting > 0) {
+      if (subcount > 1) pthread_cond_broadcast(&walk->available);
+                   else pthread_cond_signal(&walk->available);
+    }
+    else if (walk->pending_count >= KK_WALK_SPAWN_PENDING && walk->started < walk->max_workers && !walk->stop) {
+      if (pthread_create(&walk->workers[walk->started], NULL, &kk_walk_worker, walk) == 0) {
+        walk->started++;
+      }
+      else {
+        walk->max_workers = walk->started;  // do not try again
+      }
+    }
+  }
+  walk->active--;
+  return batch;
+}
+
+static void* kk_walk_worker(void* arg) {
+  kk_os_walk_t* walk = (kk_os_walk_t*)arg;
+  pthread_mutex_lock(&walk->lock);
+  while (true) {
+    // get a directory to read
+    while (!walk->stop && !walk->failed && (walk->pending == NULL || walk->ready_count >= KK_WALK_MAX_READY) && (walk->pending != NULL || walk->active > 0)) {
+      walk->waiting++;
+      pthread_cond_wait(&walk->available, &walk->lock);
+      walk->waiting--;
+    }
+    if (walk->stop || walk->failed || walk->pending == NULL) break;  // stopped, or no more work and no active threads
+    kk_walk_dir_t* dir = walk->pending;
+    walk->pending = dir->next;
+    walk->pending_count--;
+    walk->active++;
+    pthread_mutex_unlock(&walk->lock);
+
+    kk_walk_batch_t* batch = kk_walk_step(walk, dir);   // returns with the lock held
+    if (batch != NULL) {
+      if (walk->ready_last == NULL) { walk->ready_first = batch; }
+                               else { walk->ready_last->next = batch; }
+      walk->ready_last = batch;
+      walk->ready_count++;
+    }
+    pthread_cond_signal(&walk->ready);
+  }
+  pthread_cond_signal(&walk->ready);
+  pthread_mutex_unlock(&walk->lock);
+  pthread_cond_broadcast(&walk->available);
+  return NULL;
+}
+
+kk_decl_export int kk_os_walk_directory(kk_string_t dir, kk_ssize_t max_depth, bool skip_hidden, kk_os_walk_t** walk, kk_context_t* ctx) {
+  *walk = NULL;
+  kk_ssize_t dirlen;
+  const uint8_t* cdir = kk_string_buf_borrow(dir, &dirlen);
+  kk_walk_dir_t* root = kk_walk_dir_alloc(cdir, (size_t)dirlen, 0);
+  kk_string_drop(dir, ctx);
+  if (root == NULL) return ENOMEM;
+  kk_os_walk_t* w = (kk_os_walk_t*)kk_zalloc(kk_ssizeof(kk_os_walk_t), ctx);
+  w->max_depth = max_depth;
+  w->skip_hidden = skip_hidden;
+  w->max_workers = kk_cpu_available(ctx) - 1;   // the caller reads directories too
+  if (w->max_workers > KK_WALK_MAX_THREADS) w->max_workers = KK_WALK_MAX_THREADS;
+  if (w->max_workers < 0) w->max_workers = 0;
+  pthread_mutex_init(&w->lock, NULL);
+  pthread_cond_init(&w->available, NULL);
+  pthread_cond_init(&w->ready, NULL);
+
+  // read the root directory first (which also checks if it exists)
+  if (max_depth < 0) {
+    free(root);
+  }
+  else {
+    kk_walk_batch_t* batch = (kk_walk_batch_t*)calloc(1, sizeof(kk_walk_batch_t));
+    kk_ssize_t subcount = 0;
+    const int err = (batch == NULL ? ENOMEM : kk_walk_read_dir(w, root, batch, &w->pending, &subcount));
+    free(root);
+    w->pending_count = subcount;
+    w->current = batch;
+    if (err != 0) {
+      kk_os_walk_free(w, ctx);
+      return err;
+    }
+  }
+  *walk = w;
+  return 0;
+}
+
+// Return the next entry of the walk (or NULL at the end).
+kk_decl_export const char* kk_os_walk_next(kk_os_walk_t* walk, char* kind) {
+  if (kind != NULL) *kind = 0;
+  if (walk == NULL) return NULL;
+  while (true) {
+    kk_walk_batch_t* b = walk->current;
+    if (b != NULL && walk->current_ofs < b->len) {
+      const uint8_t* rec = b->data + walk->current_ofs;
+      walk->current_ofs += strlen((const char*)rec + 1) + 2;
+      if (kind != NULL) *kind = (char)rec[0];
+      return (const char*)(rec + 1);
+    }
+    kk_walk_batch_free(b);
+    walk->current = NULL;
+    walk->current_ofs = 0;
+    // get the next batch
+    pthread_mutex_lock(&walk->lock);
+    while (!walk->failed && walk->ready_first == NULL && walk->pending == NULL && walk->active > 0) {
+      pthread_cond_wait(&walk->ready, &walk->lock);
+    }
+    if (walk->failed) {
+      pthread_mutex_unlock(&walk->lock);
+      return NULL;
+    }
+    if (walk->ready_first != NULL) {
+      walk->current = walk->ready_first;
+      walk->ready_first = walk->current->next;
+      if (walk->ready_first == NULL) walk->ready_last = NULL;
+      walk->ready_count--;
+      const bool wake = (walk->waiting > 0 && walk->pending != NULL);  // a worker may wait for room
+      pthread_mutex_unlock(&walk->lock);
+      if (wake) pthread_cond_signal(&walk->available);
+    }
+    else if (walk->pending != NULL) {
+      // no batch is ready: read a directory ourselves
+      kk_walk_dir_t* dir = walk->pending;
+      walk->pending = dir->next;
+      walk->pending_count--;
+      walk->active++;
+      pthread_mutex_unlock(&walk->lock);
+      walk->current = kk_walk_step(walk, dir);  // returns with the lock held
+      const bool done = (walk->pending == NULL && walk->active == 0);
+      pthread_mutex_unlock(&walk->lock);
+      if (done) pthread_cond_broadcast(&walk->available);  // let the workers exit
+    }
+    else {
+      // no pending directories and no active threads
+      pthread_mutex_unlock(&walk->lock);
+      return NULL;
+    }
+  }
+}
+
+// Did the walk end early as it ran out of memory?
+kk_decl_export int kk_os_walk_error(kk_os_walk_t* walk) {
+  if (walk == NULL) return 0;
+  pthread_mutex_lock(&walk->lock);
+  const bool failed = walk->failed;
+  pthread_mutex_unlock(&walk->lock);
+  return (failed ? ENOMEM : 0);
+}
+
+kk_decl_export void kk_os_walk_free(kk_os_walk_t* walk, kk_context_t* ctx) {
+  if (walk == NULL) return;
+  // stop the workers
+  pthread_mutex_lock(&walk->lock);
+  walk->stop = true;
+  pthread_mutex_unlock(&walk->lock);
+  pthread_cond_broadcast(&walk->available);
+  for (kk_ssize_t i = 0; i < walk->started; i++) {
+    pthread_join(walk->workers[i], NULL);
+  }
+  // and free all remaining directories and batches
+  while (walk->pending != NULL) {
+    kk_walk_dir_t* dir = walk->pending;
+    walk->pending = dir->next;
+    free(dir);
+  }
+  while (walk->ready_first != NULL) {
+    kk_walk_batch_t* b = walk->ready_first;
+    walk->ready_first = b->next;
+    kk_walk_batch_free(b);
+  }
+  kk_walk_batch_free(walk->current);
+  pthread_cond_destroy(&walk->ready);
+  pthread_cond_destroy(&walk->available);
+  pthread_mutex_destroy(&walk->lock);
+  kk_free(walk, ctx);
+}
+
+#endif
+
 /*--------------------------------------------------------------------------------------------------
   Run system command
 --------------------------------------------------------------------------------------------------*/
@@ -596,11 +1348,17 @@ kk_decl_export int kk_os_run_command(kk_string_t cmd, kk_string_t* output, kk_co
 #endif
   kk_string_drop(cmd, ctx);
   if (f == NULL) return errno;
-  kk_string_t out = kk_string_empty();
-  char buf[1025];
-  while (fgets(buf, 1024, f) != NULL) {
-    buf[1024] = 0; // paranoia
-    out = kk_string_cat(out, kk_string_alloc_from_qutf8(buf,ctx), ctx);  // todo: avoid allocation
+  // read into a growable buffer (to stay linear in the output size)
+  kk_ssize_t len = 0;
+  kk_ssize_t cap = 4096;
+  char* buf = (char*)kk_malloc(cap, ctx);
+  size_t n;
+  while ((n = fread(buf + len, 1, kk_to_size_t(cap - len), f)) > 0) {
+    len += (kk_ssize_t)n;
+    if (len == cap) {
+      cap *= 2;
+      buf = (char*)kk_realloc(buf, cap, ctx);
+    }
   }
   if (feof(f)) errno = 0;
 #if defined(WIN32)
@@ -608,12 +1366,14 @@ kk_decl_export int kk_os_run_command(kk_string_t cmd, kk_string_t* output, kk_co
 #else
   pclose(f);
 #endif
-  *output = out;
+  *output = kk_string_alloc_from_qutf8n(len, buf, ctx);
+  kk_free(buf, ctx);
   return errno;
 }
 
 kk_decl_export int kk_os_run_system(kk_string_t cmd, kk_context_t* ctx) {
   int exitcode = 0;
+  kk_flush(ctx);  // the command writes to the same console
   #if defined(WIN32)
   kk_with_string_as_qutf16w_borrow(cmd, wcmd, ctx) {
     exitcode = _wsystem(wcmd);
@@ -629,6 +1389,338 @@ kk_decl_export int kk_os_run_system(kk_string_t cmd, kk_context_t* ctx) {
 
 
 
+/*--------------------------------------------------------------------------------------------------
+  Processes: spawn a program (without a shell) with pipes for stdin, stdout, and stderr.
+  The output is read into growable buffers while the input is written, using `poll`
+  on all pipes to avoid dead-lock when the program produces a lot of output.
+--------------------------------------------------------------------------------------------------*/
+
+#if defined(WIN32)
+
+kk_decl_export int kk_os_process_spawn(kk_vector_t argv, kk_string_t input, kk_os_process_t** proc, kk_context_t* ctx) {
+  kk_vector_drop(argv, ctx);
+  kk_string_drop(input, ctx);
+  *proc = NULL;
+  return ENOSYS;
+}
+
+kk_decl_export int kk_os_process_read_line(kk_os_process_t* proc, bool* is_stderr, kk_string_t* line, bool* eof, kk_context_t* ctx) {
+  kk_unused(proc); kk_unused(ctx);
+  *is_stderr = false;
+  *eof = true;
+  *line = kk_string_empty();
+  return ENOSYS;
+}
+
+kk_decl_export int kk_os_process_read_all(kk_os_process_t* proc, kk_string_t* out, kk_string_t* err, kk_context_t* ctx) {
+  kk_unused(proc); kk_unused(ctx);
+  *out = kk_string_empty();
+  *err = kk_string_empty();
+  return ENOSYS;
+}
+
+kk_decl_export int kk_os_process_wait(kk_os_process_t* proc, int* exitcode, kk_context_t* ctx) {
+  kk_unused(proc); kk_unused(ctx);
+  *exitcode = -1;
+  return ENOSYS;
+}
+
+kk_decl_export void kk_os_process_free(kk_os_process_t* proc, kk_context_t* ctx) {
+  kk_unused(proc); kk_unused(ctx);
+}
+
+#else
+#include <spawn.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+typedef struct kk_os_pipe_buf_s {
+  int        fd;       // read end of the pipe (or -1 if closed)
+  uint8_t*   data;
+  kk_ssize_t len;
+  kk_ssize_t cap;
+  kk_ssize_t scanned;  // there is no newline in `data[0..scanned)`
+} kk_os_pipe_buf_t;
+
+struct kk_os_process_s {
+  pid_t            pid;
+  bool             exited;
+  int              exitcode;
+  int              in_fd;     // write end of the stdin pipe (or -1 if closed)
+  kk_string_t      input;
+  kk_ssize_t       input_ofs;
+  kk_os_pipe_buf_t outputs[2]; // stdout and stderr
+};
+
+static void kk_os_fd_close(int* fd) {
+  if (*fd >= 0) {
+    close(*fd);
+    *fd = -1;
+  }
+}
+
+// create a pipe whose descriptors are close-on-exec (atomically where `pipe2` is available,
+// so a process spawned concurrently by another thread cannot inherit them)
+static int kk_os_pipe(int fds[2]) {
+  #if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+  if (pipe2(fds, O_CLOEXEC) < 0) return errno;
+  #else
+  if (pipe(fds) < 0) return errno;
+  if (fcntl(fds[0], F_SETFD, FD_CLOEXEC) < 0 || fcntl(fds[1], F_SETFD, FD_CLOEXEC) < 0) return errno;
+  #endif
+  return 0;
+}
+
+static int kk_os_fd_set_nonblock(int fd) {
+  int flags = fcntl(fd, F_GETFL);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) return errno;
+  return 0;
+}
+
+kk_decl_export int kk_os_process_spawn(kk_vector_t argv, kk_string_t input, kk_os_process_t** proc, kk_context_t* ctx) {
+  *proc = NULL;
+  kk_ssize_t argc;
+  kk_box_t* args = kk_vector_buf_borrow(argv, &argc);
+  if (argc <= 0) {
+    kk_vector_drop(argv, ctx);
+    kk_string_drop(input, ctx);
+    return EINVAL;
+  }
+  char** cargv = (char**)kk_malloc((argc + 1) * kk_ssizeof(char*), ctx);
+  for (kk_ssize_t i = 0; i < argc; i++) {
+    cargv[i] = (char*)kk_string_cbuf_borrow(kk_string_unbox(args[i]), NULL);
+  }
+  cargv[argc] = NULL;
+
+  int pin[2]  = { -1, -1 };
+  int pout[2] = { -1, -1 };
+  int perr[2] = { -1, -1 };
+  int err = 0;
+  err = kk_os_pipe(pin);
+  if (err == 0) err = kk_os_pipe(pout);
+  if (err == 0) err = kk_os_pipe(perr);
+  if (err == 0) err = kk_os_fd_set_nonblock(pin[1]);
+  if (err == 0) err = kk_os_fd_set_nonblock(pout[0]);
+  if (err == 0) err = kk_os_fd_set_nonblock(perr[0]);
+  pid_t pid = 0;
+  if (err == 0) {
+    // the original pipe descriptors are close-on-exec; only the dup2'd ones survive
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pin[0], 0);
+    posix_spawn_file_actions_adddup2(&actions, pout[1], 1);
+    posix_spawn_file_actions_adddup2(&actions, perr[1], 2);
+    err = posix_spawnp(&pid, cargv[0], &actions, NULL, cargv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+  }
+  kk_free(cargv, ctx);
+  kk_vector_drop(argv, ctx);
+  kk_os_fd_close(&pin[0]);
+  kk_os_fd_close(&pout[1]);
+  kk_os_fd_close(&perr[1]);
+  if (err != 0) {
+    kk_os_fd_close(&pin[1]);
+    kk_os_fd_close(&pout[0]);
+    kk_os_fd_close(&perr[0]);
+    kk_string_drop(input, ctx);
+    return err;
+  }
+
+  kk_os_process_t* p = (kk_os_process_t*)kk_zalloc(kk_ssizeof(kk_os_process_t), ctx);
+  p->pid = pid;
+  p->in_fd = pin[1];
+  p->input = input;
+  p->outputs[0].fd = pout[0];
+  p->outputs[1].fd = perr[0];
+  if (kk_string_is_empty_borrow(input)) {
+    kk_os_fd_close(&p->in_fd);
+  }
+  *proc = p;
+  return 0;
+}
+
+// Write a chunk of input without getting killed by `SIGPIPE` if the process closed its input.
+static int kk_os_process_write_input(kk_os_process_t* p) {
+  kk_ssize_t len;
+  const uint8_t* buf = kk_string_buf_borrow(p->input, &len);
+  kk_ssize_t todo = len - p->input_ofs;
+  if (todo > 64*1024) todo = 64*1024;
+  sigset_t pipe_set, old_set;
+  sigemptyset(&pipe_set);
+  sigaddset(&pipe_set, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+  kk_ssize_t n = write(p->in_fd, buf + p->input_ofs, kk_to_size_t(todo));
+  int err = (n < 0 ? errno : 0);
+  if (err == EPIPE) {
+    // consume the pending SIGPIPE (if it was not already pending before)
+    sigset_t pending;
+    sigpending(&pending);
+    if (sigismember(&pending, SIGPIPE) && !sigismember(&old_set, SIGPIPE)) {
+      struct timespec zero = { 0, 0 };
+      sigtimedwait(&pipe_set, NULL, &zero);
+    }
+  }
+  pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+  if (n > 0) {
+    p->input_ofs += n;
+    if (p->input_ofs >= len) kk_os_fd_close(&p->in_fd);
+  }
+  else if (err == EPIPE) {
+    kk_os_fd_close(&p->in_fd);  // the process no longer reads its input
+  }
+  else if (err != EAGAIN && err != EINTR) {
+    return err;
+  }
+  return 0;
+}
+
+static int kk_os_pipe_buf_read(kk_os_pipe_buf_t* b, kk_context_t* ctx) {
+  if (b->cap - b->len < 4*1024) {
+    b->cap = (b->cap < 16*1024 ? 16*1024 : 2*b->cap);
+    b->data = (uint8_t*)kk_realloc(b->data, b->cap, ctx);
+  }
+  kk_ssize_t n = read(b->fd, b->data + b->len, kk_to_size_t(b->cap - b->len));
+  if (n > 0) {
+    b->len += n;
+  }
+  else if (n == 0) {
+    kk_os_fd_close(&b->fd);  // eof
+  }
+  else if (errno != EAGAIN && errno != EINTR) {
+    return errno;
+  }
+  return 0;
+}
+
+// Wait for any of the pipes to become ready and transfer data.
+static int kk_os_process_pump(kk_os_process_t* p, kk_context_t* ctx) {
+  struct pollfd fds[3];
+  int nfds = 0;
+  if (p->in_fd >= 0) {
+    fds[nfds].fd = p->in_fd; fds[nfds].events = POLLOUT; fds[nfds].revents = 0; nfds++;
+  }
+  for (int i = 0; i < 2; i++) {
+    if (p->outputs[i].fd >= 0) {
+      fds[nfds].fd = p->outputs[i].fd; fds[nfds].events = POLLIN; fds[nfds].revents = 0; nfds++;
+    }
+  }
+  if (nfds == 0) return 0;
+  if (poll(fds, (nfds_t)nfds, -1) < 0) {
+    return (errno == EINTR || errno == EAGAIN ? 0 : errno);
+  }
+  for (int j = 0; j < nfds; j++) {
+    if (fds[j].revents == 0) continue;
+    int err = 0;
+    if (fds[j].fd == p->in_fd) {
+      err = kk_os_process_write_input(p);
+    }
+    else {
+      kk_os_pipe_buf_t* b = (fds[j].fd == p->outputs[0].fd ? &p->outputs[0] : &p->outputs[1]);
+      err = kk_os_pipe_buf_read(b, ctx);
+    }
+    if (err != 0) return err;
+  }
+  return 0;
+}
+
+static kk_string_t kk_os_pipe_buf_take(kk_os_pipe_buf_t* b, kk_ssize_t len, kk_ssize_t skip, kk_context_t* ctx) {
+  kk_string_t s = kk_string_alloc_from_qutf8n(len, (const char*)b->data, ctx);
+  const kk_ssize_t consumed = len + skip;
+  if (consumed < b->len) {
+    memmove(b->data, b->data + consumed, kk_to_size_t(b->len - consumed));
+  }
+  b->len -= consumed;
+  b->scanned = 0;
+  return s;
+}
+
+kk_decl_export int kk_os_process_read_line(kk_os_process_t* p, bool* is_stderr, kk_string_t* line, bool* eof, kk_context_t* ctx) {
+  *is_stderr = false;
+  *eof = false;
+  *line = kk_string_empty();
+  while (true) {
+    for (int i = 0; i < 2; i++) {
+      kk_os_pipe_buf_t* b = &p->outputs[i];
+      const uint8_t* nl = (b->len > b->scanned ? (const uint8_t*)memchr(b->data + b->scanned, '\n', kk_to_size_t(b->len - b->scanned)) : NULL);
+      if (nl != NULL) {
+        *is_stderr = (i == 1);
+        *line = kk_os_pipe_buf_take(b, nl - b->data, 1, ctx);
+        return 0;
+      }
+      b->scanned = b->len;
+      if (b->fd < 0 && b->len > 0) {
+        // final line without a newline
+        *is_stderr = (i == 1);
+        *line = kk_os_pipe_buf_take(b, b->len, 0, ctx);
+        return 0;
+      }
+    }
+    if (p->outputs[0].fd < 0 && p->outputs[1].fd < 0) {
+      *eof = true;  // end of all output
+      return 0;
+    }
+    const int err = kk_os_process_pump(p, ctx);
+    if (err != 0) return err;
+  }
+}
+
+kk_decl_export int kk_os_process_read_all(kk_os_process_t* p, kk_string_t* out, kk_string_t* err, kk_context_t* ctx) {
+  int res = 0;
+  while (res == 0 && (p->outputs[0].fd >= 0 || p->outputs[1].fd >= 0)) {
+    res = kk_os_process_pump(p, ctx);
+  }
+  *out = kk_os_pipe_buf_take(&p->outputs[0], p->outputs[0].len, 0, ctx);
+  *err = kk_os_pipe_buf_take(&p->outputs[1], p->outputs[1].len, 0, ctx);
+  return res;
+}
+
+kk_decl_export int kk_os_process_wait(kk_os_process_t* p, int* exitcode, kk_context_t* ctx) {
+  // keep reading the output to avoid dead-lock on a full pipe
+  int err = 0;
+  while (err == 0 && (p->outputs[0].fd >= 0 || p->outputs[1].fd >= 0)) {
+    err = kk_os_process_pump(p, ctx);
+  }
+  kk_os_fd_close(&p->in_fd);
+  if (err == 0 && !p->exited) {
+    int status = 0;
+    pid_t res;
+    do {
+      res = waitpid(p->pid, &status, 0);
+    } while (res < 0 && errno == EINTR);
+    if (res < 0) {
+      err = errno;
+    }
+    else {
+      p->exited = true;
+      p->exitcode = (WIFEXITED(status) ? WEXITSTATUS(status) : (WIFSIGNALED(status) ? 128 + WTERMSIG(status) : -1));
+    }
+  }
+  *exitcode = p->exitcode;
+  return err;
+}
+
+// Free a process; if it is still running it is killed.
+kk_decl_export void kk_os_process_free(kk_os_process_t* p, kk_context_t* ctx) {
+  if (p == NULL) return;
+  kk_os_fd_close(&p->in_fd);
+  for (int i = 0; i < 2; i++) {
+    kk_os_fd_close(&p->outputs[i].fd);
+    kk_free(p->outputs[i].data, ctx);
+  }
+  if (!p->exited) {
+    kill(p->pid, SIGKILL);
+    while (waitpid(p->pid, NULL, 0) < 0 && errno == EINTR) { };
+  }
+  kk_string_drop(p->input, ctx);
+  kk_free(p, ctx);
+}
+
+#endif
+
 /*--------------------------------------------------------------------------------------------------
   Args
 --------------------------------------------------------------------------------------------------*/
@@ -1238,6 +2330,129 @@ int kk_cpu_count(kk_context_t* ctx) {
   return (cpu_count < 1 ? 1 : cpu_count);
 }
 
+#if defined(__linux__)
+#include <sched.h>
+
+// Read a small text file into `buf` (zero terminated); returns `false` on failure.
+static bool kk_read_small_file(const char* fname, char* buf, size_t bufsize) {
+  FILE* f = fopen(fname, "r");
+  if (f == NULL) return false;
+  const size_t n = fread(buf, 1, bufsize - 1, f);
+  fclose(f);
+  buf[n] = 0;
+  return (n > 0);
+}
+
+static int kk_cpu_quota_count(long long quota, long long period) {
+  if (quota <= 0 || period <= 0) return 0;
+  return (int)((quota + period - 1) / period);  // round up
+}
+
+// Return the cpu's allowed by the cgroup CPU quota (rounded up), or 0 if there is no quota.
+static int kk_cpu_cgroup_quota(void) {
+  char buf[1024];
+  int cpus = 0;
+  // cgroup v2: `cpu.max` contains "<quota> <period>" (or "max <period>") in our cgroup and any of its parents
+  if (kk_read_small_file("/proc/self/cgroup", buf, sizeof(buf))) {
+    const char* line = buf;
+    while (line != NULL && strncmp(line, "0::", 3) != 0) {
+      line = strchr(line, '\n');
+      if (line != NULL) line++;
+    }
+    if (line != NULL) {
+      const char* base = "/sys/fs/cgroup";
+      const size_t baselen = strlen(base);
+      char path[512];
+      snprintf(path, sizeof(path), "%s%.*s", base, (int)strcspn(line + 3, "\n"), line + 3);
+      size_t len = strlen(path);
+      while (len > baselen && path[len-1] == '/') { path[--len] = 0; }
+      while (true) {
+        char fname[600];
+        long long quota = 0;
+        long long period = 0;
+        snprintf(fname, sizeof(fname), "%s/cpu.max", path);
+        if (kk_read_small_file(fname, buf, sizeof(buf)) && sscanf(buf, "%lld %lld", &quota, &period) == 2) {
+          const int count = kk_cpu_quota_count(quota, period);
+          if (count > 0 && (cpus == 0 || count < cpus)) cpus = count;
+        }
+        char* slash = strrchr(path, '/');
+        if (slash == NULL || (size_t)(slash - path) < baselen) break;
+        *slash = 0;
+      }
+    }
+  }
+  // cgroup v1: `cpu.cfs_quota_us` is -1 if there is no quota
+  if (cpus == 0) {
+    const char* dirs[2] = { "/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct" };
+    for (int i = 0; i < 2 && cpus == 0; i++) {
+      char fname[128];
+      long long quota = 0;
+      long long period = 0;
+      snprintf(fname, sizeof(fname), "%s/cpu.cfs_quota_us", dirs[i]);
+      if (!kk_read_small_file(fname, buf, sizeof(buf)) || sscanf(buf, "%lld", &quota) != 1) continue;
+      snprintf(fname, sizeof(fname), "%s/cpu.cfs_period_us", dirs[i]);
+      if (!kk_read_small_file(fname, buf, sizeof(buf)) || sscanf(buf, "%lld", &period) != 1) continue;
+      cpus = kk_cpu_quota_count(quota, period);
+    }
+  }
+  return cpus;
+}
+
+kk_decl_export int kk_cpu_numa_cpus(int node, int* cpus, int max_cpus) {
+  char fname[128];
+  char buf[1024];
+  snprintf(fname, sizeof(fname), "/sys/devices/system/node/node%d/cpulist", node);
+  if (node < 0 || !kk_read_small_file(fname, buf, sizeof(buf))) return -1;
+  // parse a list of ranges, like "0-3,8-11"
+  int count = 0;
+  const char* p = buf;
+  while (*p >= '0' && *p <= '9') {
+    char* end;
+    const long lo = strtol(p, &end, 10);
+    long hi = lo;
+    if (*end == '-') hi = strtol(end + 1, &end, 10);
+    for (long cpu = lo; cpu <= hi; cpu++) {
+      if (count < max_cpus) cpus[count] = (int)cpu;
+      count++;
+    }
+    p = (*end == ',' ? end + 1 : end);
+  }
+  return count;
+}
+#else
+kk_decl_export int kk_cpu_numa_cpus(int node, int* cpus, int max_cpus) {
+  kk_unused(node); kk_unused(cpus); kk_unused(max_cpus);
+  return -1;
+}
+#endif
+
+kk_decl_export void kk_cpu_info(kk_cpu_info_t* info, kk_context_t* ctx) {
+  info->host_count = kk_cpu_count(ctx);
+  info->affinity_count = info->host_count;
+  info->quota_count = 0;
+  info->numa_nodes = 1;
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    const int count = CPU_COUNT(&set);
+    if (count > 0 && count < info->affinity_count) info->affinity_count = count;
+  }
+  info->quota_count = kk_cpu_cgroup_quota();
+  int nodes = 0;
+  while (nodes < 1024 && kk_cpu_numa_cpus(nodes, NULL, 0) > 0) { nodes++; }
+  if (nodes > 1) info->numa_nodes = nodes;
+#endif
+  info->available = info->affinity_count;
+  if (info->quota_count > 0 && info->quota_count < info->available) info->available = info->quota_count;
+}
+
+kk_decl_export int kk_cpu_available(kk_context_t* ctx) {
+  kk_cpu_info_t info;
+  kk_cpu_info(&info, ctx);
+  return info.available;
+}
+
 bool kk_cpu_is_little_endian(kk_context_t* ctx) {
   kk_unused(ctx);
   #if KK_ARCH_LITTLE_ENDIAN
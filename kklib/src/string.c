@@ -15,6 +15,15 @@
 #include "kklib.h"
 #include <string.h>
 #include <stdio.h>
+#if defined(WIN32)
+#include <io.h>
+#define kk_isatty(fd)  _isatty(fd)
+#define kk_fileno(f)   _fileno(f)
+#else
+#include <unistd.h>
+#define kk_isatty(fd)  isatty(fd)
+#define kk_fileno(f)   fileno(f)
+#endif
 
 
 // Allow reading aligned words as long as some bytes in it are part of a valid C object
@@ -851,21 +860,189 @@ kk_string_t  kk_string_trim_right(kk_string_t str, kk_context_t* ctx) {
 
 --------------------------------------------------------------------------------------------------*/
 
+/*--------------------------------------------------------------------------------------------------
+  Buffered console output. Each context has its own buffer which is written with a single
+  `fwrite`, so output of different threads is interleaved at the granularity of whole
+  `kk_print` calls (and never in the middle of a line printed with `kk_println`).
+
+  All buffers are kept in a global registry so they can be flushed at process exit, even
+  when they belong to (worker) threads that are still running. A buffer is never freed; when
+  its context is freed it is flushed and can be claimed again by a later context. The owning
+  thread marks its buffer busy while appending so the exit flush never sees a partial update.
+--------------------------------------------------------------------------------------------------*/
+
+typedef enum kk_output_state_e {
+  KK_OUTPUT_FREE,    // not owned by any context
+  KK_OUTPUT_IDLE,    // owned by a context
+  KK_OUTPUT_BUSY,    // owned, and the owner is updating the buffer
+  KK_OUTPUT_CLOSED   // flushed at process exit; owners write directly from now on
+} kk_output_state_t;
+
+typedef struct kk_output_s {
+  struct kk_output_s* next;  // next in the registry
+  _Atomic(intptr_t) state;   // `kk_output_state_t`
+  kk_ssize_t len;
+  kk_ssize_t cap;
+  bool       line_buffered;  // flush on newlines (if `stdout` is a terminal)
+  uint8_t    buf[1];
+} kk_output_t;
+
+static _Atomic(kk_ssize_t) kk_output_buffer_size = KK_OUTPUT_BUFFER_SIZE;
+static _Atomic(kk_output_t*) kk_outputs;  // = NULL, the registry of all buffers
+static _Atomic(intptr_t) kk_outputs_closed; // = 0, set at process exit
+
+static void kk_output_write(const uint8_t* s, kk_ssize_t len) {
+  if (len > 0) {
+    fwrite(s, 1, kk_to_size_t(len), stdout);
+    fflush(stdout);
+  }
+}
+
+static bool kk_output_try_set_state(kk_output_t* out, intptr_t expected, intptr_t desired) {
+  return kk_atomic_cas_strong_acq_rel(&out->state, &expected, desired);
+}
+
+static kk_output_t* kk_output_get(kk_context_t* ctx) {
+  kk_output_t* out = ctx->output;
+  if (kk_likely(out != NULL)) return out;
+  const kk_ssize_t cap = kk_atomic_load_relaxed(&kk_output_buffer_size);
+  // claim a free buffer of a previous context
+  for (out = kk_atomic_load_acquire(&kk_outputs); out != NULL; out = out->next) {
+    if (out->cap == cap && kk_output_try_set_state(out, KK_OUTPUT_FREE, KK_OUTPUT_IDLE)) {
+      ctx->output = out;
+      return out;
+    }
+  }
+  // or allocate and register a fresh one
+  out = (kk_output_t*)kk_malloc(kk_ssizeof(kk_output_t) + cap, ctx);
+  out->len = 0;
+  out->cap = cap;
+  out->line_buffered = (kk_isatty(kk_fileno(stdout)) != 0);
+  kk_atomic_store_relaxed(&out->state, (kk_atomic_load_acquire(&kk_outputs_closed) != 0 ? KK_OUTPUT_CLOSED : KK_OUTPUT_IDLE));
+  kk_output_t* head = kk_atomic_load_relaxed(&kk_outputs);
+  do {
+    out->next = head;
+  } while (!kk_atomic_cas_weak_acq_rel(&kk_outputs, &head, out));
+  ctx->output = out;
+  return out;
+}
+
+// Start updating the buffer; returns `false` if it was closed at process exit.
+static bool kk_output_enter(kk_output_t* out) {
+  return kk_output_try_set_state(out, KK_OUTPUT_IDLE, KK_OUTPUT_BUSY);
+}
+
+static void kk_output_leave(kk_output_t* out) {
+  kk_atomic_store_release(&out->state, KK_OUTPUT_IDLE);
+}
+
+static void kk_output_flush_buffer(kk_output_t* out) {
+  if (out->len > 0) {
+    kk_output_write(out->buf, out->len);
+    out->len = 0;
+  }
+}
+
+kk_unit_t kk_flush(kk_context_t* ctx) {
+  kk_output_t* out = ctx->output;
+  if (out != NULL && kk_output_enter(out)) {
+    kk_output_flush_buffer(out);
+    kk_output_leave(out);
+  }
+  return kk_Unit;
+}
+
+void kk_output_free(kk_context_t* ctx) {
+  kk_output_t* out = ctx->output;
+  if (out == NULL) return;
+  if (kk_output_enter(out)) {
+    kk_output_flush_buffer(out);
+    kk_atomic_store_release(&out->state, KK_OUTPUT_FREE);  // can be claimed by another context
+  }
+  ctx->output = NULL;
+}
+
+// Called at process exit: flush the buffers of all threads.
+void kk_output_done(void) {
+  kk_atomic_store_release(&kk_outputs_closed, 1);
+  for (kk_output_t* out = kk_atomic_load_acquire(&kk_outputs); out != NULL; out = out->next) {
+    // wait for a busy owner to finish its update (which never blocks)
+    while (!kk_output_try_set_state(out, KK_OUTPUT_IDLE, KK_OUTPUT_CLOSED) &&
+           !kk_output_try_set_state(out, KK_OUTPUT_FREE, KK_OUTPUT_CLOSED)) {
+      if (kk_atomic_load_acquire(&out->state) == KK_OUTPUT_CLOSED) break;
+    }
+    kk_output_flush_buffer(out);
+  }
+}
+
+void kk_output_set_buffer_size(kk_ssize_t size, kk_context_t* ctx) {
+  if (size < 0) size = 0;
+  kk_atomic_store_relaxed(&kk_output_buffer_size, size);
+  kk_output_free(ctx);  // a buffer of the new size is claimed on demand
+}
+
+// Write a string (and newline) directly with a single `fwrite`.
+static void kk_output_write_line(const uint8_t* s, kk_ssize_t len, bool newline, kk_context_t* ctx) {
+  if (!newline) {
+    kk_output_write(s, len);
+    return;
+  }
+  uint8_t* line = (uint8_t*)kk_malloc(len + 1, ctx);
+  if (line == NULL) {
+    kk_output_write(s, len);
+    kk_output_write((const uint8_t*)"\n", 1);
+    return;
+  }
+  memcpy(line, s, kk_to_size_t(len));
+  line[len] = '\n';
+  kk_output_write(line, len + 1);
+  kk_free(line, ctx);
+}
+
+static void kk_output_append(const uint8_t* s, kk_ssize_t len, bool newline, kk_context_t* ctx) {
+  kk_output_t* out = kk_output_get(ctx);
+  if (!kk_output_enter(out)) {
+    // closed at process exit
+    kk_output_write_line(s, len, newline, ctx);
+    return;
+  }
+  const kk_ssize_t total = len + (newline ? 1 : 0);
+  if (out->len + total > out->cap) {
+    kk_output_flush_buffer(out);
+    if (total > out->cap) {
+      // too large to buffer: write directly
+      kk_output_write_line(s, len, newline, ctx);
+      kk_output_leave(out);
+      return;
+    }
+  }
+  memcpy(out->buf + out->len, s, kk_to_size_t(len));
+  out->len += len;
+  if (newline) { out->buf[out->len++] = '\n'; }
+  if (out->line_buffered && (newline || memchr(s, '\n', kk_to_size_t(len)) != NULL)) {
+    kk_output_flush_buffer(out);
+  }
+  kk_output_leave(out);
+}
+
 kk_unit_t kk_println(kk_string_t s, kk_context_t* ctx) {
-  // TODO: set locale to utf-8?
-  puts(kk_string_cbuf_borrow(s, NULL));  // todo: allow printing embedded 0 characters?
+  kk_ssize_t len;
+  const uint8_t* buf = kk_string_buf_borrow(s, &len);
+  kk_output_append(buf, len, true, ctx);
   kk_string_drop(s, ctx);
   return kk_Unit;
 }
 
 kk_unit_t kk_print(kk_string_t s, kk_context_t* ctx) {
-  // TODO: set locale to utf-8?
-  fputs(kk_string_cbuf_borrow(s, NULL), stdout); // todo: allow printing embedded 0 characters?
+  kk_ssize_t len;
+  const uint8_t* buf = kk_string_buf_borrow(s, &len);
+  kk_output_append(buf, len, false, ctx);
   kk_string_drop(s, ctx);
   return kk_Unit;
 }
 
 kk_unit_t kk_trace(kk_string_t s, kk_context_t* ctx) {
+  if (ctx->output != NULL && ctx->output->line_buffered) kk_flush(ctx);  // keep the order on a terminal
   fputs(kk_string_cbuf_borrow(s, NULL), stderr); // todo: allow printing embedded 0 characters?
   fputs("\n", stderr);
   kk_string_drop(s, ctx);
@@ -93,6 +93,15 @@ static int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex) {
   }
 }
 
+static int pthread_cond_wait_msecs(pthread_cond_t* cond, pthread_mutex_t* mutex, kk_msecs_t timeout) {
+  if (SleepConditionVariableCS(cond, mutex, (DWORD)timeout)) {
+    return 0;
+  }
+  else {
+    return (GetLastError() == ERROR_TIMEOUT ? ETIMEDOUT : EINVAL);
+  }
+}
+
 static void pthread_cond_signal(pthread_cond_t* cond) {
   WakeConditionVariable(cond);
 }
@@ -131,10 +140,25 @@ static int pthread_once(pthread_once_t* once, void (*init)(void)) {
 ---------------------------------------------------------------------------*/
 #else
 #include <pthread.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 static void pthread_join_void(pthread_t thread) {
   pthread_join(thread, NULL);
 }
+
+static int pthread_cond_wait_msecs(pthread_cond_t* cond, pthread_mutex_t* mutex, kk_msecs_t timeout) {
+  struct timespec tm;
+  clock_gettime(CLOCK_REALTIME, &tm);
+  tm.tv_sec  += (time_t)(timeout / 1000);
+  tm.tv_nsec += (long)(timeout % 1000) * 1000000L;
+  if (tm.tv_nsec >= 1000000000L) {
+    tm.tv_nsec -= 1000000000L;
+    tm.tv_sec  += 1;
+  }
+  return pthread_cond_timedwait(cond, mutex, &tm);
+}
 #endif
 
 
@@ -144,6 +168,7 @@ static void pthread_join_void(pthread_t thread) {
 
 typedef struct promise_s {
   kk_box_t        result;
+  bool            cancelled;    // set if cancelled before a result was available
   pthread_mutex_t lock;
   pthread_cond_t  available;
 } promise_t;
@@ -151,7 +176,8 @@ typedef struct promise_s {
 
 static kk_promise_t kk_promise_alloc( kk_context_t* ctx );
 static void         kk_promise_set( kk_promise_t pr, kk_box_t r, kk_context_t* ctx );
-// static bool         kk_promise_available( kk_promise_t pr, kk_context_t* ctx );
+static bool         kk_promise_is_cancelled_borrow( kk_promise_t pr );
+static void         kk_promise_cancel_borrow( kk_promise_t pr, kk_context_t* ctx );
 
 
 
@@ -185,7 +211,7 @@ static kk_task_t* kk_task_alloc( kk_function_t fun, kk_promise_t p, kk_context_t
 }
 
 static void kk_task_exec( kk_task_t* task, kk_context_t* ctx ) {
-  if (task->fun != NULL) {
+  if (task->fun != NULL && !kk_promise_is_cancelled_borrow(task->promise)) {  // skip cancelled tasks
     kk_function_dup(task->fun);      
     kk_box_t res = kk_function_call(kk_box_t,(kk_function_t,kk_context_t*),task->fun,(task->fun,ctx));
     kk_box_dup(task->promise);
@@ -199,47 +225,66 @@ static void kk_task_exec( kk_task_t* task, kk_context_t* ctx ) {
   task group (thread pool with task queue)
 ---------------------------------------------------------------------------*/
 
-typedef struct kk_task_group_s {
-  bool            done;
+typedef struct kk_task_queue_s {
   kk_task_t*      tasks;
   kk_task_t*      tasks_tail;
-  pthread_cond_t  tasks_available;
-  pthread_mutex_t tasks_lock;
-  pthread_t*      threads;
-  kk_ssize_t      thread_count;
+} kk_task_queue_t;
+
+typedef struct kk_task_group_s {
+  bool             done;
+  kk_task_queue_t* queues;         // a task queue per NUMA node (or a single queue if not NUMA aware)
+  kk_ssize_t       queue_count;
+  kk_ssize_t       queued;         // total number of tasks in all queues
+  pthread_cond_t   tasks_available;
+  pthread_mutex_t  tasks_lock;
+  pthread_t*       threads;
+  kk_ssize_t       thread_count;
+  _Atomic(kk_ssize_t) started;     // used to assign a node to each worker
+  _Atomic(kk_ssize_t) tasks_run;
 } kk_task_group_t;
 
+// The queue (NUMA node) of the current thread; the main thread uses the first queue.
+static kk_decl_thread kk_ssize_t kk_task_node;
+
 static bool kk_tasks_is_empty( kk_task_group_t* tg ) {
-  return (tg->tasks == NULL);
+  return (tg->queued == 0);
 }
 
+// Dequeue from the queue of the current node first, and otherwise steal from the other nodes.
 static kk_task_t* kk_tasks_dequeue( kk_task_group_t* tg ) {
-  kk_task_t* task = tg->tasks;
-  if (task != NULL) {
-    tg->tasks = task->next;
-    if (tg->tasks == NULL) { 
-      kk_assert(tg->tasks_tail == task);
-      tg->tasks_tail = NULL; 
+  kk_task_t* task = NULL;
+  for (kk_ssize_t i = 0; i < tg->queue_count && task == NULL; i++) {
+    kk_task_queue_t* q = &tg->queues[(kk_task_node + i) % tg->queue_count];
+    task = q->tasks;
+    if (task != NULL) {
+      q->tasks = task->next;
+      if (q->tasks == NULL) {
+        kk_assert(q->tasks_tail == task);
+        q->tasks_tail = NULL;
+      }
+      tg->queued--;
     }
   }
   kk_assert(task != NULL || tg->done);
   return task;
 }
 
-static void kk_tasks_enqueue_n( kk_task_group_t* tg, kk_task_t* thead, kk_task_t* ttail, kk_context_t*  ctx ) {
+static void kk_tasks_enqueue_n( kk_task_group_t* tg, kk_task_t* thead, kk_task_t* ttail, kk_ssize_t n, kk_context_t*  ctx ) {
   kk_unused(ctx);
-  if (tg->tasks_tail != NULL) {
-    kk_assert(tg->tasks_tail->next == NULL);
-    tg->tasks_tail->next = thead;
+  kk_task_queue_t* q = &tg->queues[kk_task_node % tg->queue_count];
+  if (q->tasks_tail != NULL) {
+    kk_assert(q->tasks_tail->next == NULL);
+    q->tasks_tail->next = thead;
   }
   else {
-    tg->tasks = thead;
+    q->tasks = thead;
   }
-  tg->tasks_tail = ttail;
+  q->tasks_tail = ttail;
+  tg->queued += n;
 }
 
 static void kk_tasks_enqueue( kk_task_group_t* tg, kk_task_t* task, kk_context_t* ctx ) {
-  kk_tasks_enqueue_n( tg, task, task, ctx );
+  kk_tasks_enqueue_n( tg, task, task, 1, ctx );
 }
 
 static kk_promise_t kk_task_group_schedule( kk_task_group_t* tg, kk_function_t fun, kk_context_t* ctx ) {
@@ -252,14 +297,61 @@ static kk_promise_t kk_task_group_schedule( kk_task_group_t* tg, kk_function_t f
   return p;
 }
 
+static void kk_task_group_exec( kk_task_group_t* tg, kk_task_t* task, kk_context_t* ctx ) {
+  kk_task_exec(task,ctx);
+  kk_atomic_inc_relaxed(&tg->tasks_run);
+}
+
+// Run a queued task of the task group of the current thread (if any); returns `true` if a task was run.
+static bool kk_task_group_help( kk_context_t* ctx ) {
+  kk_task_group_t* tg = ctx->task_group;
+  if (tg == NULL) return false;
+  kk_task_t* task = NULL;
+  pthread_mutex_lock(&tg->tasks_lock);
+  if (!kk_tasks_is_empty(tg) && !tg->done) {
+    task = kk_tasks_dequeue(tg);
+  }
+  pthread_mutex_unlock(&tg->tasks_lock);
+  if (task == NULL) return false;
+  kk_task_group_exec(tg, task, ctx);
+  return true;
+}
+
+// Pin the current thread to the cpu's of a NUMA node.
+static void kk_task_pin_to_node( kk_ssize_t node ) {
+#if defined(__linux__)
+  int cpus[1024];
+  const int count = kk_cpu_numa_cpus((int)node, cpus, 1024);
+  if (count <= 0 || count > 1024) return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int i = 0; i < count; i++) {
+    if (cpus[i] >= 0 && cpus[i] < CPU_SETSIZE) CPU_SET(cpus[i], &set);
+  }
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);  // ignore failure
+#else
+  kk_unused(node);
+#endif
+}
+
 static void* kk_task_group_worker( void* vtg ) {
   kk_task_group_t* tg = (kk_task_group_t*)vtg;
   kk_context_t*    ctx = kk_get_context();
   ctx->task_group = tg;
+  kk_task_node = kk_atomic_inc_relaxed(&tg->started) % tg->queue_count;
+  if (tg->queue_count > 1) {
+    kk_task_pin_to_node(kk_task_node);
+  }
   while(true) {
      // deqeue task
      kk_task_t* task = NULL;
      pthread_mutex_lock(&tg->tasks_lock);
+     if (kk_tasks_is_empty(tg) && !tg->done) {
+       // about to become idle: write any buffered output first
+       pthread_mutex_unlock(&tg->tasks_lock);
+       kk_flush(ctx);
+       pthread_mutex_lock(&tg->tasks_lock);
+     }
      while (kk_tasks_is_empty(tg) && !tg->done) {
        pthread_cond_wait(&tg->tasks_available, &tg->tasks_lock);
      }
@@ -268,7 +360,7 @@ static void* kk_task_group_worker( void* vtg ) {
      if (task == NULL) {  // due to tg->done
        break;
      }
-     kk_task_exec(task,ctx);
+     kk_task_group_exec(tg,task,ctx);
      // todo: ensure context is cleared again?
   }
   ctx->task_group = NULL;
@@ -279,18 +371,25 @@ static void* kk_task_group_worker( void* vtg ) {
 
 void kk_task_group_free( kk_task_group_t* tg, kk_context_t* ctx ) {
   if (tg==NULL) return;  
-  // set done state
+  // set done state and take all queued tasks
   kk_task_t* task = NULL;
-  tg->done = true;
   pthread_mutex_lock(&tg->tasks_lock);
-  task = tg->tasks;
-  tg->tasks = NULL;
-  tg->tasks_tail = NULL;
+  for (kk_ssize_t i = 0; i < tg->queue_count; i++) {
+    kk_task_queue_t* q = &tg->queues[i];
+    if (q->tasks_tail != NULL) {
+      q->tasks_tail->next = task;
+      task = q->tasks;
+    }
+    q->tasks = NULL;
+    q->tasks_tail = NULL;
+  }
+  tg->queued = 0;
   tg->done = true;
   pthread_mutex_unlock(&tg->tasks_lock);
-  // free tasks
+  // cancel and free tasks
   while( task != NULL ) {
     kk_task_t* next = task->next;
+    kk_promise_cancel_borrow(task->promise,ctx);
     kk_task_free(task,ctx);
     task = next;  
   }
@@ -303,33 +402,50 @@ void kk_task_group_free( kk_task_group_t* tg, kk_context_t* ctx ) {
   }
   pthread_cond_destroy(&tg->tasks_available);
   pthread_mutex_destroy(&tg->tasks_lock);
+  kk_free(tg->queues,ctx);
   kk_free(tg->threads,ctx);
   kk_free(tg,ctx);
 }
 
 static _Atomic(kk_ssize_t) default_concurrency;  // = 0
+static _Atomic(kk_ssize_t) default_numa_aware;   // = 0
 
 void kk_task_set_default_concurrency(kk_ssize_t thread_cnt, kk_context_t* ctx) {
-  const kk_ssize_t cpu_count = kk_cpu_count(ctx);
+  const kk_ssize_t cpu_count = kk_cpu_available(ctx);
   if (thread_cnt < 0) { thread_cnt = 0; }
   else if (thread_cnt > 8*cpu_count) { thread_cnt = 8*cpu_count; };
   kk_atomic_store_release(&default_concurrency, thread_cnt);
 }
 
+void kk_task_set_numa_aware(bool enable, kk_context_t* ctx) {
+  kk_unused(ctx);
+  kk_atomic_store_release(&default_numa_aware, (enable ? 1 : 0));
+}
+
 static kk_task_group_t* kk_task_group_alloc( kk_ssize_t thread_cnt, kk_context_t* ctx ) {
   if (thread_cnt <= 0) {
     thread_cnt = kk_atomic_load_acquire(&default_concurrency);
   }
-  const kk_ssize_t cpu_count = kk_cpu_count(ctx);
+  // size by the cpu's we can actually use (respecting the affinity mask and cgroup CPU quota)
+  kk_cpu_info_t info;
+  kk_cpu_info(&info, ctx);
+  const kk_ssize_t cpu_count = info.available;
   if (thread_cnt <= 0) { thread_cnt = cpu_count + (cpu_count > 16 ? cpu_count/4 : cpu_count/2); }
   if (thread_cnt > 8*cpu_count) { thread_cnt = 8*cpu_count; };  
+  // only use NUMA placement if requested, on multiple nodes, and when we are not restricted to a subset of the cpu's
+  kk_ssize_t queue_cnt = 1;
+  if (kk_atomic_load_acquire(&default_numa_aware) != 0 && info.numa_nodes > 1 && info.available == info.host_count) {
+    queue_cnt = info.numa_nodes;
+  }
   kk_task_group_t* tg = (kk_task_group_t*)kk_zalloc( kk_ssizeof(kk_task_group_t), ctx );
   if (tg==NULL) return NULL;
   tg->threads = (pthread_t*)kk_zalloc( (thread_cnt+1) * sizeof(pthread_t), ctx );
   if (tg->threads == NULL) goto err;
+  tg->queues = (kk_task_queue_t*)kk_zalloc( queue_cnt * kk_ssizeof(kk_task_queue_t), ctx );
+  if (tg->queues == NULL) goto err;
+  tg->queue_count = queue_cnt;
+  tg->queued = 0;
   tg->thread_count = thread_cnt;
-  tg->tasks = NULL;
-  tg->tasks_tail = NULL;
   if (pthread_cond_init(&tg->tasks_available, NULL) != 0) goto err;
   if (pthread_mutex_init(&tg->tasks_lock, NULL) != 0) goto err;
   for (kk_ssize_t i = 0; i < tg->thread_count; i++) {
@@ -345,6 +461,7 @@ err_threads:
   
 err:
   if (tg != NULL) {
+    if (tg->queues != NULL) { kk_free(tg->queues,ctx); }
     if (tg->threads != NULL) { kk_free(tg->threads,ctx); }
     kk_free(tg,ctx); 
   }
@@ -368,6 +485,23 @@ kk_promise_t kk_task_schedule( kk_function_t fun, kk_context_t* ctx ) {
   return kk_task_group_schedule( task_group, fun, ctx );
 }
 
+void kk_task_stats( kk_task_stats_t* stats, kk_context_t* ctx ) {
+  kk_cpu_info(&stats->cpu, ctx);
+  stats->thread_count = 0;
+  stats->queue_count = 0;
+  stats->queued = 0;
+  stats->tasks_run = 0;
+  kk_task_group_t* tg = task_group;  // NULL if no task was scheduled yet
+  if (tg != NULL) {
+    stats->thread_count = tg->thread_count;
+    stats->queue_count = tg->queue_count;
+    pthread_mutex_lock(&tg->tasks_lock);
+    stats->queued = tg->queued;
+    pthread_mutex_unlock(&tg->tasks_lock);
+    stats->tasks_run = kk_atomic_load_relaxed(&tg->tasks_run);
+  }
+}
+
 
 
 /*---------------------------------------------------------------------------
@@ -399,82 +533,272 @@ err:
 }
 
 
+// Waiters in `kk_promise_wait_any` block on a global condition that is signaled when any
+// promise is resolved or cancelled (only if there are such waiters).
+static pthread_once_t      promise_any_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t     promise_any_lock;
+static pthread_cond_t      promise_any_available;
+static kk_ssize_t          promise_any_generation;  // protected by `promise_any_lock`
+static _Atomic(kk_ssize_t) promise_any_waiters;
+
+static void kk_promise_any_init(void) {
+  pthread_mutex_init(&promise_any_lock, NULL);
+  pthread_cond_init(&promise_any_available, NULL);
+}
+
+static void kk_promise_notify_any(void) {
+  if (kk_atomic_load_acquire(&promise_any_waiters) > 0) {
+    pthread_mutex_lock(&promise_any_lock);
+    promise_any_generation++;
+    pthread_mutex_unlock(&promise_any_lock);
+    pthread_cond_broadcast(&promise_any_available);
+  }
+}
+
+static bool kk_promise_is_done( promise_t* p ) {
+  return (p->cancelled || !kk_box_is_any(p->result));
+}
+
 static void kk_promise_set( kk_promise_t pr, kk_box_t r, kk_context_t* ctx ) {
   promise_t* p = (promise_t*)kk_cptr_raw_unbox(pr);
   kk_box_mark_shared(r,ctx);
   pthread_mutex_lock(&p->lock);
-  kk_box_drop(p->result,ctx);
-  p->result = r;
+  if (p->cancelled) {
+    kk_box_drop(r,ctx);   // nobody is interested in the result anymore
+  }
+  else {
+    kk_box_drop(p->result,ctx);
+    p->result = r;
+  }
   pthread_mutex_unlock(&p->lock);
-  pthread_cond_signal(&p->available);
+  pthread_cond_broadcast(&p->available);
+  kk_promise_notify_any();
   kk_box_drop(pr,ctx);
 }
 
-/*
-static bool kk_promise_available( kk_promise_t pr, kk_context_t* ctx ) {
+static bool kk_promise_is_cancelled_borrow( kk_promise_t pr ) {
   promise_t* p = (promise_t*)kk_cptr_raw_unbox(pr);
   pthread_mutex_lock(&p->lock);
-  bool available = !kk_box_is_any(p->result);
+  const bool cancelled = p->cancelled;
   pthread_mutex_unlock(&p->lock);
+  return cancelled;
+}
+
+static void kk_promise_cancel_borrow( kk_promise_t pr, kk_context_t* ctx ) {
+  kk_unused(ctx);
+  promise_t* p = (promise_t*)kk_cptr_raw_unbox(pr);
+  pthread_mutex_lock(&p->lock);
+  const bool cancel = !kk_promise_is_done(p);
+  if (cancel) { p->cancelled = true; }
+  pthread_mutex_unlock(&p->lock);
+  if (cancel) {
+    pthread_cond_broadcast(&p->available);
+    kk_promise_notify_any();
+  }
+}
+
+void kk_promise_cancel( kk_promise_t pr, kk_context_t* ctx ) {
+  kk_promise_cancel_borrow(pr,ctx);
   kk_box_drop(pr,ctx);
-  return available;
 }
-*/
 
-kk_box_t kk_promise_get( kk_promise_t pr, kk_context_t* ctx ) {  
+kk_promise_status_t kk_promise_wait( kk_promise_t pr, kk_msecs_t timeout, kk_box_t* result, kk_context_t* ctx ) {
   promise_t* p = (promise_t*)kk_cptr_raw_unbox(pr);
+  const kk_timer_t start = (timeout >= 0 ? kk_timer_start() : 0);
+  kk_promise_status_t status = KK_PROMISE_OK;
+  *result = kk_box_null;
   pthread_mutex_lock(&p->lock);
-  while (kk_box_is_any(p->result)) {
-    // if part of a task group, run other tasks while waiting
-    if (ctx->task_group != NULL) {
+  while (!kk_promise_is_done(p)) {
+    // if part of a task group, run other tasks while waiting (but not with a timeout,
+    // since a task we pick up can run for much longer than the timeout)
+    if (timeout < 0) {
       pthread_mutex_unlock(&p->lock);
-      // try to get a task
-      kk_task_group_t* tg = ctx->task_group;
-      kk_task_t* task = NULL;
-      pthread_mutex_lock(&tg->tasks_lock);
-      if (!kk_tasks_is_empty(tg) && !tg->done) {
-        task = kk_tasks_dequeue(tg);
-      }
-      pthread_mutex_unlock(&tg->tasks_lock);
-      // run task
-      if (task != NULL) { 
-        kk_task_exec(task, ctx);
-        pthread_mutex_lock(&p->lock);        
-      }
-      else {        
-        pthread_mutex_lock(&p->lock);
-        if (kk_box_is_any(p->result)) {
-          pthread_cond_wait( &p->available, &p->lock);
-        }
-        /*
-        // no task, block for a while
-        struct timespec tm;
-        clock_gettime(CLOCK_REALTIME, &tm);
-        tm.tv_nsec     +=  100000000;  // 0.1s
-        if (tm.tv_nsec >= 1000000000) {
-          tm.tv_nsec   -= 1000000000;
-          tm.tv_sec += 1;
-        }
-        pthread_mutex_lock(&p->lock);
-        if (kk_box_is_any(p->result)) {
-          if (pthread_cond_timedwait( &p->available, &p->lock, &tm) == ETIMEDOUT) {
-            pthread_mutex_lock(&p->lock); 
-          }
-        }
-        */        
-      }
+      const bool ran = kk_task_group_help(ctx);
+      pthread_mutex_lock(&p->lock);
+      if (ran || kk_promise_is_done(p)) continue;
     }
-    // if in the main thread do a blocking wait
-    else {
+    // otherwise block
+    if (timeout < 0) {
       pthread_cond_wait( &p->available, &p->lock );
     }
+    else {
+      const kk_msecs_t elapsed = kk_timer_end(start) / 1000;
+      if (elapsed >= timeout) {
+        status = KK_PROMISE_TIMEOUT;
+        break;
+      }
+      pthread_cond_wait_msecs( &p->available, &p->lock, timeout - elapsed );
+    }
   }
-  pthread_mutex_unlock(&p->lock);  
-  const kk_box_t result = kk_box_dup( p->result );
+  if (status == KK_PROMISE_OK) {
+    if (p->cancelled) { status = KK_PROMISE_CANCELLED; }
+                 else { *result = kk_box_dup(p->result); }
+  }
+  pthread_mutex_unlock(&p->lock);
   kk_box_drop(pr,ctx);
+  return status;
+}
+
+kk_box_t kk_promise_get( kk_promise_t pr, kk_context_t* ctx ) {
+  kk_box_t result;
+  if (kk_promise_wait(pr, -1, &result, ctx) != KK_PROMISE_OK) {
+    result = kk_box_any(ctx);
+  }
   return result;
 }
 
+kk_promise_status_t kk_promise_wait_any( kk_vector_t promises, kk_msecs_t timeout, kk_ssize_t* index, kk_box_t* result, kk_context_t* ctx ) {
+  pthread_once( &promise_any_once, &kk_promise_any_init );
+  kk_atomic_inc_release(&promise_any_waiters);
+  const kk_timer_t start = (timeout >= 0 ? kk_timer_start() : 0);
+  kk_ssize_t n;
+  kk_box_t* prs = kk_vector_buf_borrow(promises, &n);
+  kk_promise_status_t status = KK_PROMISE_CANCELLED;
+  *index = -1;
+  *result = kk_box_null;
+  while (true) {
+    pthread_mutex_lock(&promise_any_lock);
+    const kk_ssize_t generation = promise_any_generation;
+    pthread_mutex_unlock(&promise_any_lock);
+    // find the first available result (skipping cancelled promises)
+    bool all_cancelled = true;
+    for (kk_ssize_t i = 0; i < n && *index < 0; i++) {
+      promise_t* p = (promise_t*)kk_cptr_raw_unbox(prs[i]);
+      pthread_mutex_lock(&p->lock);
+      if (!p->cancelled) {
+        all_cancelled = false;
+        if (!kk_box_is_any(p->result)) {
+          *index = i;
+          *result = kk_box_dup(p->result);
+        }
+      }
+      pthread_mutex_unlock(&p->lock);
+    }
+    if (*index >= 0) { status = KK_PROMISE_OK; break; }
+    if (all_cancelled) { status = KK_PROMISE_CANCELLED; break; }
+    kk_msecs_t remaining = -1;
+    if (timeout >= 0) {
+      remaining = timeout - (kk_timer_end(start) / 1000);
+      if (remaining <= 0) { status = KK_PROMISE_TIMEOUT; break; }
+    }
+    // run other tasks while waiting (unless there is a timeout), or block until any promise is resolved
+    if (timeout < 0 && kk_task_group_help(ctx)) continue;
+    pthread_mutex_lock(&promise_any_lock);
+    if (generation == promise_any_generation) {
+      if (remaining < 0) { pthread_cond_wait(&promise_any_available, &promise_any_lock); }
+                    else { pthread_cond_wait_msecs(&promise_any_available, &promise_any_lock, remaining); }
+    }
+    pthread_mutex_unlock(&promise_any_lock);
+  }
+  kk_atomic_dec_relaxed(&promise_any_waiters);
+  kk_vector_drop(promises,ctx);
+  return status;
+}
+
+
+/*---------------------------------------------------------------------------
+  task scopes
+---------------------------------------------------------------------------*/
+
+typedef struct task_scope_s {
+  bool            cancelled;
+  pthread_mutex_t lock;
+  kk_promise_t*   promises;   // promises of the tasks started in this scope
+  kk_ssize_t      count;
+  kk_ssize_t      capacity;
+} task_scope_t;
+
+static void kk_task_scope_free( void* vsc, kk_block_t* b, kk_context_t* ctx ) {
+  kk_unused(b);
+  task_scope_t* sc = (task_scope_t*)vsc;
+  for (kk_ssize_t i = 0; i < sc->count; i++) {
+    kk_box_drop(sc->promises[i],ctx);
+  }
+  pthread_mutex_destroy(&sc->lock);
+  kk_free(sc->promises,ctx);
+  kk_free(sc,ctx);
+}
+
+kk_task_scope_t kk_task_scope_alloc( kk_context_t* ctx ) {
+  task_scope_t* sc = (task_scope_t*)kk_zalloc(kk_ssizeof(task_scope_t),ctx);
+  if (sc == NULL) return kk_box_any(ctx);
+  if (pthread_mutex_init(&sc->lock, NULL) != 0) {
+    kk_free(sc,ctx);
+    return kk_box_any(ctx);
+  }
+  kk_task_scope_t scope = kk_cptr_raw_box( &kk_task_scope_free, sc, ctx );
+  kk_box_mark_shared(scope,ctx);
+  return scope;
+}
+
+// Add a promise to a locked scope, first removing promises that are done if the scope is full.
+static bool kk_task_scope_add( task_scope_t* sc, kk_promise_t pr, kk_context_t* ctx ) {
+  if (sc->count >= sc->capacity) {
+    kk_ssize_t j = 0;
+    for (kk_ssize_t i = 0; i < sc->count; i++) {
+      promise_t* p = (promise_t*)kk_cptr_raw_unbox(sc->promises[i]);
+      pthread_mutex_lock(&p->lock);
+      const bool done = kk_promise_is_done(p);
+      pthread_mutex_unlock(&p->lock);
+      if (done) { kk_box_drop(sc->promises[i],ctx); }
+           else { sc->promises[j++] = sc->promises[i]; }
+    }
+    sc->count = j;
+  }
+  if (sc->count >= sc->capacity) {
+    const kk_ssize_t newcap = (sc->capacity == 0 ? 8 : 2*sc->capacity);
+    kk_promise_t* newprs = (kk_promise_t*)kk_realloc(sc->promises, newcap * kk_ssizeof(kk_promise_t), ctx);
+    if (newprs == NULL) return false;
+    sc->promises = newprs;
+    sc->capacity = newcap;
+  }
+  sc->promises[sc->count++] = pr;
+  return true;
+}
+
+kk_promise_t kk_task_schedule_in( kk_task_scope_t scope, kk_function_t fun, kk_context_t* ctx ) {
+  task_scope_t* sc = (task_scope_t*)kk_cptr_raw_unbox(scope);
+  kk_promise_t p;
+  pthread_mutex_lock(&sc->lock);
+  if (sc->cancelled) {
+    // do not start tasks in a cancelled scope
+    kk_function_drop(fun,ctx);
+    p = kk_promise_alloc(ctx);
+    kk_promise_cancel_borrow(p,ctx);
+  }
+  else {
+    p = kk_task_schedule(fun,ctx);
+    if (!kk_task_scope_add(sc, kk_box_dup(p), ctx)) {
+      kk_box_drop(p,ctx);  // out of memory: the task can no longer be cancelled through the scope
+    }
+  }
+  pthread_mutex_unlock(&sc->lock);
+  kk_box_drop(scope,ctx);
+  return p;
+}
+
+void kk_task_scope_cancel( kk_task_scope_t scope, kk_context_t* ctx ) {
+  task_scope_t* sc = (task_scope_t*)kk_cptr_raw_unbox(scope);
+  pthread_mutex_lock(&sc->lock);
+  sc->cancelled = true;
+  for (kk_ssize_t i = 0; i < sc->count; i++) {
+    kk_promise_cancel_borrow(sc->promises[i],ctx);
+    kk_box_drop(sc->promises[i],ctx);
+  }
+  sc->count = 0;
+  pthread_mutex_unlock(&sc->lock);
+  kk_box_drop(scope,ctx);
+}
+
+bool kk_task_scope_is_cancelled( kk_task_scope_t scope, kk_context_t* ctx ) {
+  task_scope_t* sc = (task_scope_t*)kk_cptr_raw_unbox(scope);
+  pthread_mutex_lock(&sc->lock);
+  const bool cancelled = sc->cancelled;
+  pthread_mutex_unlock(&sc->lock);
+  kk_box_drop(scope,ctx);
+  return cancelled;
+}
+
 
 /*---------------------------------------------------------------------------
    Lvar
@@ -557,7 +881,7 @@ kk_box_t kk_lvar_get( kk_lvar_t lvar, kk_box_t bot, kk_function_t is_gte, kk_con
       pthread_mutex_unlock(&tg->tasks_lock);
       // run task
       if (task != NULL) { 
-        kk_task_exec(task, ctx);
+        kk_task_group_exec(tg, task, ctx);
         pthread_mutex_lock(&lv->lock);        
       }
       else {
@@ -13,6 +13,10 @@
 #include <limits.h>
 #include <float.h>
 #include <inttypes.h>
+#if !defined(WIN32)
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
 
 #pragma GCC diagnostic ignored "-Wunused-function"
 #pragma GCC diagnostic ignored "-Woverlength-strings"
@@ -294,6 +298,28 @@ static void test_large(kk_context_t* ctx) {
   expect_eq(kk_integer_cdiv(kk_integer_mul(kk_integer_dup(y), kk_integer_dup(x), ctx), y, ctx), x,ctx);
 }
 
+// accumulate small ints into a (unique) big integer; these take the in-place `_small` paths
+static void test_accumulate(kk_context_t* ctx) {
+  kk_integer_t acc = kk_integer_from_str("999999999999999999999999999999999999", ctx);
+  for (int i = 0; i < 1000; i++) {
+    acc = kk_integer_add(acc, kk_integer_from_small(1), ctx);
+  }
+  expect_eq(kk_integer_dup(acc), kk_integer_from_str("1000000000000000000000000000000000999", ctx), ctx);
+  for (int i = 0; i < 1000; i++) {
+    acc = kk_integer_sub(acc, kk_integer_from_small(1), ctx);
+  }
+  expect_eq(kk_integer_dup(acc), kk_integer_from_str("999999999999999999999999999999999999", ctx), ctx);
+  acc = kk_integer_sub(kk_integer_from_small(-1), acc, ctx);
+  expect_eq(kk_integer_dup(acc), kk_integer_from_str("-1000000000000000000000000000000000000", ctx), ctx);
+  acc = kk_integer_mul(kk_integer_from_small(-2), acc, ctx);
+  expect_eq(kk_integer_dup(acc), kk_integer_from_str("2000000000000000000000000000000000000", ctx), ctx);
+  for (int i = 0; i < 20; i++) {
+    acc = kk_integer_mul(acc, kk_integer_from_small(10), ctx);
+  }
+  expect_eq(kk_integer_dup(acc), kk_integer_from_str("2e56", ctx), ctx);
+  expect_eq(kk_integer_mul(acc, kk_integer_from_small(0), ctx), kk_integer_from_small(0), ctx);
+}
+
 static void test_cdiv(kk_context_t* ctx) {
   expect_eq(kk_integer_cdiv(kk_integer_from_str("163500573666152634716420931676158",ctx), kk_integer_from_int(13579, ctx), ctx), kk_integer_from_str("12040693251797086288859336598",ctx),ctx);
   expect_eq(kk_integer_cdiv(kk_integer_from_str("163500573666152634716420931676158",ctx), kk_integer_from_int(-13579, ctx), ctx), kk_integer_from_str("-12040693251797086288859336598",ctx),ctx);
@@ -354,6 +380,8 @@ static void test_pow10(kk_context_t* ctx) {
   expect_eq(kk_integer_cdiv_pow10(kk_integer_from_str("9999999999",ctx), kk_integer_from_int(8,ctx), ctx), kk_integer_from_str("99",ctx),ctx);
   expect_eq(kk_integer_cdiv_pow10(kk_integer_from_str("1234567890",ctx), kk_integer_from_int(18,ctx), ctx), kk_integer_from_int(0,ctx),ctx);
   expect_eq(kk_integer_cdiv_pow10(kk_integer_from_str("1234e14",ctx), kk_integer_from_int(14,ctx), ctx), kk_integer_from_str("1234",ctx),ctx);
+  expect_eq(kk_integer_cdiv_pow10(kk_integer_from_str("2e18",ctx), kk_integer_from_int(18,ctx), ctx), kk_integer_from_int(2,ctx),ctx);
+  expect_eq(kk_integer_cdiv_pow10(kk_integer_from_int(-1234,ctx), kk_integer_from_int(20,ctx), ctx), kk_integer_from_int(0,ctx),ctx);
 }
 
 static kk_integer_t ia;
@@ -565,6 +593,356 @@ static void test_ovf(kk_context_t* ctx) {
   printf("\nint-inc-dec: %6.3fs\n", (double)end/1000.0);
 }
 
+static kk_vector_t test_process_argv(const char* script, kk_context_t* ctx) {
+  kk_vector_t argv = kk_vector_alloc(3, kk_box_null, ctx);
+  kk_box_t* args = kk_vector_buf_borrow(argv, NULL);
+  args[0] = kk_string_box(kk_string_alloc_dup_valid_utf8("sh", ctx));
+  args[1] = kk_string_box(kk_string_alloc_dup_valid_utf8("-c", ctx));
+  args[2] = kk_string_box(kk_string_alloc_dup_valid_utf8(script, ctx));
+  return argv;
+}
+
+static void test_process(kk_context_t* ctx) {
+#if !defined(WIN32)
+  printf("process streams lines and does not dead-lock on large output?\n");
+  kk_os_process_t* proc;
+  int err = kk_os_process_spawn(test_process_argv("cat; echo oops >&2; exit 3", ctx), kk_string_alloc_dup_valid_utf8("a\nbc", ctx), &proc, ctx);
+  bool ok = (err == 0);
+  int lines = 0;
+  int errlines = 0;
+  while (ok) {
+    bool is_stderr;
+    bool eof;
+    kk_string_t line;
+    ok = (kk_os_process_read_line(proc, &is_stderr, &line, &eof, ctx) == 0);
+    if (!ok || eof) break;
+    const char* s = kk_string_cbuf_borrow(line, NULL);
+    if (is_stderr) { errlines++; ok = (strcmp(s, "oops") == 0); }
+              else { ok = (strcmp(s, (lines == 0 ? "a" : "bc")) == 0); lines++; }
+    kk_string_drop(line, ctx);
+  }
+  int exitcode = 0;
+  ok = ok && (kk_os_process_wait(proc, &exitcode, ctx) == 0) && exitcode == 3 && lines == 2 && errlines == 1;
+  kk_os_process_free(proc, ctx);
+  // large input and output at the same time
+  const kk_ssize_t len = 4*1024*1024;
+  char* big = (char*)kk_malloc(len + 1, ctx);
+  memset(big, 'x', len); big[len] = 0;
+  err = kk_os_process_spawn(test_process_argv("cat; cat >&2 </dev/null", ctx), kk_string_alloc_raw_len(len, big, true, ctx), &proc, ctx);
+  kk_string_t out = kk_string_empty();
+  kk_string_t errout = kk_string_empty();
+  ok = ok && (err == 0) && (kk_os_process_read_all(proc, &out, &errout, ctx) == 0) && (kk_os_process_wait(proc, &exitcode, ctx) == 0);
+  kk_ssize_t outlen = 0;
+  kk_string_buf_borrow(out, &outlen);
+  ok = ok && (exitcode == 0) && (outlen == len) && kk_string_is_empty_borrow(errout);
+  kk_string_drop(out, ctx);
+  kk_string_drop(errout, ctx);
+  if (err == 0) kk_os_process_free(proc, ctx);
+  printf(" %d lines, %zd bytes: %s\n", lines, outlen, (ok ? "ok" : "FAIL"));
+  assert(ok);
+#else
+  kk_unused(ctx);
+#endif
+}
+
+static void test_walk(kk_context_t* ctx) {
+#if !defined(WIN32)
+  printf("directory walk finds all entries?\n");
+  char root[] = "/tmp/kk-walk-XXXXXX";
+  bool ok = (mkdtemp(root) != NULL);
+  char path[256];
+  int files = 0;
+  for (int i = 0; ok && i < 8; i++) {
+    snprintf(path, sizeof(path), "%s/d%d", root, i);
+    ok = (mkdir(path, 0700) == 0);
+    for (int j = 0; ok && j < 10; j++) {
+      snprintf(path, sizeof(path), "%s/d%d/f%d%s", root, i, j, (j == 0 ? "/" : ""));
+      if (j == 0) { ok = (mkdir(path, 0700) == 0); snprintf(path, sizeof(path), "%s/d%d/f0/.hidden", root, i); }
+      FILE* f = fopen(path, "w");
+      ok = ok && (f != NULL);
+      if (f != NULL) { fclose(f); files++; }
+    }
+  }
+  kk_os_walk_t* walk = NULL;
+  ok = ok && (kk_os_walk_directory(kk_string_alloc_dup_valid_utf8(root, ctx), 1000, false, &walk, ctx) == 0);
+  int nfiles = 0, ndirs = 0;
+  char kind;
+  const char* p;
+  while ((p = kk_os_walk_next(walk, &kind)) != NULL) {
+    ok = ok && (strncmp(p, root, strlen(root)) == 0);
+    if (kind == 'f') nfiles++;
+    if (kind == 'd') ndirs++;
+  }
+  ok = ok && (kk_os_walk_error(walk) == 0);
+  kk_os_walk_free(walk, ctx);
+  ok = ok && (nfiles == files && ndirs == 16);
+  // skip hidden and limit the depth
+  ok = ok && (kk_os_walk_directory(kk_string_alloc_dup_valid_utf8(root, ctx), 1, true, &walk, ctx) == 0);
+  int count = 0;
+  while (kk_os_walk_next(walk, NULL) != NULL) { count++; }
+  kk_os_walk_free(walk, ctx);
+  ok = ok && (count == 8 + 8*9 + 8);
+  // stop halfway
+  ok = ok && (kk_os_walk_directory(kk_string_alloc_dup_valid_utf8(root, ctx), 1000, false, &walk, ctx) == 0);
+  for (int i = 0; i < 20; i++) { ok = ok && (kk_os_walk_next(walk, NULL) != NULL); }
+  kk_os_walk_free(walk, ctx);
+  snprintf(path, sizeof(path), "rm -rf %s", root);
+  ok = (system(path) == 0) && ok;
+  printf(" %d files, %d directories: %s\n", nfiles, ndirs, (ok ? "ok" : "FAIL"));
+  assert(ok);
+#else
+  kk_unused(ctx);
+#endif
+}
+
+static void test_output(kk_context_t* ctx) {
+#if !defined(WIN32)
+  printf("console output is buffered in order?\n");
+  fflush(stdout);
+  int fds[2];
+  bool ok = (pipe(fds) == 0);
+  const int saved = dup(1);
+  ok = ok && (saved >= 0) && (dup2(fds[1], 1) >= 0);
+  kk_output_set_buffer_size(16, ctx);
+  if (ok) {
+    kk_print(kk_string_alloc_dup_valid_utf8("ab", ctx), ctx);
+    kk_println(kk_string_alloc_dup_valid_utf8("cd", ctx), ctx);
+    kk_println(kk_string_alloc_dup_valid_utf8("a line longer than the buffer", ctx), ctx);
+    kk_print(kk_string_alloc_dup_valid_utf8("xxx", ctx), ctx);  // no newline
+    kk_flush(ctx);
+    dup2(saved, 1);
+  }
+  kk_output_set_buffer_size(KK_OUTPUT_BUFFER_SIZE, ctx);
+  char buf[128] = { 0 };
+  const char* expect = "abcd\na line longer than the buffer\nxxx";
+  ok = ok && (read(fds[0], buf, sizeof(buf) - 1) == (ssize_t)strlen(expect)) && (strcmp(buf, expect) == 0);
+  if (saved >= 0) close(saved);
+  close(fds[0]);
+  close(fds[1]);
+  printf(" %s\n", (ok ? "ok" : "FAIL"));
+  assert(ok);
+#else
+  kk_unused(ctx);
+#endif
+}
+
+// Chunk `i` of `n` consists of `i % 37` bytes with value `i`
+static kk_vector_t test_bytes_chunks(int n, kk_context_t* ctx) {
+  kk_box_t* elems;
+  kk_vector_t v = kk_vector_alloc_uninit(n, &elems, ctx);
+  for (int i = 0; i < n; i++) {
+    uint8_t* buf;
+    kk_bytes_t chunk = kk_bytes_alloc_buf(i % 37, &buf, ctx);
+    memset(buf, (uint8_t)i, (size_t)(i % 37));
+    elems[i] = kk_bytes_box(chunk);
+  }
+  return v;
+}
+
+static void test_bytes(kk_context_t* ctx) {
+#if !defined(WIN32)
+  printf("binary files with vectored writes?\n");
+  const char* path = "/tmp/kk-bytes-test.bin";
+  const int n = 200;  // more chunks than fit in a single `writev` batch
+  size_t total = 0;
+  for (int i = 0; i < n; i++) total += (size_t)(i % 37);
+  bool ok = (kk_os_write_bytes(kk_string_alloc_dup_valid_utf8(path, ctx), test_bytes_chunks(n, ctx), false, ctx) == 0);
+  ok = ok && (kk_os_write_bytes(kk_string_alloc_dup_valid_utf8(path, ctx), test_bytes_chunks(3, ctx), true, ctx) == 0);
+  kk_bytes_t content = kk_bytes_empty();
+  ok = ok && (kk_os_read_bytes(kk_string_alloc_dup_valid_utf8(path, ctx), &content, ctx) == 0);
+  kk_ssize_t len;
+  const uint8_t* buf = kk_bytes_buf_borrow(content, &len);
+  ok = ok && (len == (kk_ssize_t)(total + 1 + 2));
+  size_t ofs = 0;
+  for (int i = 0; ok && i < n; i++) {
+    for (int j = 0; ok && j < i % 37; j++) ok = (buf[ofs++] == (uint8_t)i);
+  }
+  ok = ok && (buf[ofs] == 1 && buf[ofs+1] == 2 && buf[ofs+2] == 2);
+  kk_bytes_drop(content, ctx);
+  // positional reads and writes
+  kk_os_file_t* file = NULL;
+  ok = ok && (kk_os_file_open(kk_string_alloc_dup_valid_utf8(path, ctx), true, false, &file, ctx) == 0);
+  ok = ok && (kk_os_file_pwrite(file, 1, test_bytes_chunks(3, ctx), ctx) == 0);
+  kk_bytes_t part = kk_bytes_empty();
+  ok = ok && (kk_os_file_pread(file, 0, 4, &part, ctx) == 0);
+  buf = kk_bytes_buf_borrow(part, &len);
+  ok = ok && (len == 4 && buf[0] == 1 && buf[1] == 1 && buf[2] == 2 && buf[3] == 2);
+  kk_bytes_drop(part, ctx);
+  int64_t fsize = 0;
+  ok = ok && (kk_os_file_size(file, &fsize) == 0) && (fsize == (int64_t)(total + 3));
+  ok = ok && (kk_os_file_pread(file, fsize - 2, 10, &part, ctx) == 0) && (kk_bytes_len_borrow(part) == 2);
+  kk_bytes_drop(part, ctx);
+  ok = ok && (kk_os_file_close(file) == 0) && (kk_os_file_pread(file, 0, 1, &part, ctx) == EBADF);
+  kk_os_file_free(file, ctx);
+  unlink(path);
+  printf(" %d bytes: %s\n", (int)(total + 3), (ok ? "ok" : "FAIL"));
+  assert(ok);
+#else
+  kk_unused(ctx);
+#endif
+}
+
+static void test_atomic_write(kk_context_t* ctx) {
+#if !defined(WIN32)
+  printf("atomic text file writes?\n");
+  char root[] = "/tmp/kk-atomic-XXXXXX";
+  bool ok = (mkdtemp(root) != NULL);
+  char path[256];
+  snprintf(path, sizeof(path), "%s/out.txt", root);
+  const char* parts[] = { "hello", ", ", "world", "", "\n" };
+  for (int round = 0; ok && round < 3; round++) {
+    kk_box_t* elems;
+    kk_vector_t v = kk_vector_alloc_uninit(5, &elems, ctx);
+    for (int i = 0; i < 5; i++) elems[i] = kk_string_box(kk_string_alloc_dup_valid_utf8(parts[i], ctx));
+    ok = (kk_os_write_text_file_atomic(kk_string_alloc_dup_valid_utf8(path, ctx), v, (kk_os_fsync_t)round, ctx) == 0);
+    if (round == 0) ok = ok && (chmod(path, 0640) == 0);  // the mode of an existing file is kept
+  }
+  struct stat st;
+  ok = ok && (stat(path, &st) == 0) && ((st.st_mode & 0777) == 0640);
+  kk_string_t content = kk_string_empty();
+  ok = ok && (kk_os_read_text_file(kk_string_alloc_dup_valid_utf8(path, ctx), &content, ctx) == 0);
+  ok = ok && (strcmp(kk_string_cbuf_borrow(content, NULL), "hello, world\n") == 0);
+  kk_string_drop(content, ctx);
+  // no temporary files are left behind
+  kk_vector_t entries;
+  ok = ok && (kk_os_list_directory(kk_string_alloc_dup_valid_utf8(root, ctx), &entries, ctx) == 0);
+  if (ok) ok = (kk_vector_len(entries, ctx) == 1);
+  // writing into a missing directory fails cleanly
+  snprintf(path, sizeof(path), "%s/missing/out.txt", root);
+  ok = ok && (kk_os_write_text_file_atomic(kk_string_alloc_dup_valid_utf8(path, ctx), kk_vector_empty(), KK_FSYNC_NONE, ctx) == ENOENT);
+  snprintf(path, sizeof(path), "rm -rf %s", root);
+  ok = (system(path) == 0) && ok;
+  printf(" %s\n", (ok ? "ok" : "FAIL"));
+  assert(ok);
+#else
+  kk_unused(ctx);
+#endif
+}
+
+static kk_box_t test_task_fun(kk_function_t fself, kk_context_t* ctx) {
+  kk_unused(fself);
+  return kk_integer_box(kk_integer_from_small(42));
+}
+
+static void test_cpu_info(kk_context_t* ctx) {
+  printf("cpu info and task workers respect affinity and quota?\n");
+  kk_cpu_info_t info;
+  kk_cpu_info(&info, ctx);
+  bool ok = (info.host_count >= 1 && info.affinity_count >= 1 && info.affinity_count <= info.host_count);
+  ok = ok && (info.available >= 1 && info.available <= info.affinity_count);
+  ok = ok && (info.quota_count == 0 || info.available <= info.quota_count);
+  ok = ok && (info.numa_nodes >= 1) && (kk_cpu_available(ctx) == info.available);
+  kk_task_stats_t stats;
+  kk_task_stats(&stats, ctx);
+  ok = ok && (stats.cpu.available == info.available && stats.thread_count == 0 && stats.tasks_run == 0);
+  // workers are sized by the available cpu's
+  kk_define_static_function(fun, test_task_fun, ctx);
+  kk_promise_t ps[8];
+  for (int i = 0; i < 8; i++) { ps[i] = kk_task_schedule(kk_function_dup(fun), ctx); }
+  for (int i = 0; i < 8; i++) { ok = ok && (kk_integer_clamp32(kk_integer_unbox(kk_promise_get(ps[i], ctx)), ctx) == 42); }
+  kk_task_stats(&stats, ctx);
+  ok = ok && (stats.thread_count >= 1 && stats.thread_count <= 2*info.available && stats.queue_count == 1);
+  ok = ok && (stats.tasks_run == 8 && stats.queued == 0);
+  printf(" host %d, affinity %d, quota %d, available %d, numa nodes %d: %s\n", info.host_count, info.affinity_count,
+         info.quota_count, info.available, info.numa_nodes, (ok ? "ok" : "FAIL"));
+  assert(ok);
+}
+
+static _Atomic(int) test_slow_count;
+
+static kk_box_t test_task_slow(kk_function_t fself, kk_context_t* ctx) {
+  kk_unused(fself);
+  usleep(50*1000);
+  kk_atomic_inc_relaxed(&test_slow_count);
+  return kk_integer_box(kk_integer_from_small(2));
+}
+
+static kk_box_t test_task_fast(kk_function_t fself, kk_context_t* ctx) {
+  kk_unused(fself);
+  return kk_integer_box(kk_integer_from_small(1));
+}
+
+static void test_task_scope(kk_context_t* ctx) {
+#if !defined(WIN32)
+  printf("task scopes cancel outstanding tasks?\n");
+  kk_define_static_function(slow, test_task_slow, ctx);
+  kk_define_static_function(fast, test_task_fast, ctx);
+  // time out while a worker runs the task
+  kk_promise_t p = kk_task_schedule(kk_function_dup(slow), ctx);
+  usleep(20*1000);
+  kk_box_t result;
+  bool ok = (kk_promise_wait(kk_box_dup(p), 5, &result, ctx) == KK_PROMISE_TIMEOUT);
+  ok = ok && (kk_promise_wait(p, -1, &result, ctx) == KK_PROMISE_OK) && (kk_integer_clamp32(kk_integer_unbox(result), ctx) == 2);
+  // the first result wins and the remaining tasks are cancelled
+  const int before = kk_atomic_load_relaxed(&test_slow_count);
+  kk_task_scope_t scope = kk_task_scope_alloc(ctx);
+  kk_box_t* ps;
+  kk_vector_t v = kk_vector_alloc_uninit(5, &ps, ctx);
+  for (int i = 0; i < 4; i++) { ps[i] = kk_task_schedule_in(kk_box_dup(scope), kk_function_dup(slow), ctx); }
+  ps[4] = kk_task_schedule_in(kk_box_dup(scope), kk_function_dup(fast), ctx);
+  kk_ssize_t index = -1;
+  ok = ok && (kk_promise_wait_any(kk_vector_dup(v), -1, &index, &result, ctx) == KK_PROMISE_OK);
+  // note: with a single worker the main thread helps and may run some slow tasks first
+  ok = ok && (index >= 0) && (kk_integer_clamp32(kk_integer_unbox(result), ctx) == (index == 4 ? 1 : 2));
+  kk_task_scope_cancel(kk_box_dup(scope), ctx);
+  int cancelled = 0;
+  for (int i = 0; i < 4; i++) {
+    const kk_promise_status_t status = kk_promise_wait(kk_box_dup(ps[i]), -1, &result, ctx);
+    if (status == KK_PROMISE_CANCELLED) { cancelled++; }
+    else if (status == KK_PROMISE_OK) { kk_box_drop(result, ctx); }
+    else { ok = false; }
+  }
+  // tasks in a cancelled scope are not started
+  p = kk_task_schedule_in(kk_box_dup(scope), kk_function_dup(fast), ctx);
+  ok = ok && (kk_promise_wait(p, -1, &result, ctx) == KK_PROMISE_CANCELLED) && kk_task_scope_is_cancelled(scope, ctx);
+  usleep(100*1000);  // let running tasks finish
+  const int ran = kk_atomic_load_relaxed(&test_slow_count) - before;
+  ok = ok && (ran <= 4) && (ran + cancelled >= 4);  // each slow task either ran or was cancelled (or both if it was running)
+  // waiting for any of the cancelled promises fails
+  ok = ok && (kk_promise_wait_any(v, -1, &index, &result, ctx) != KK_PROMISE_TIMEOUT);
+  printf(" %d of 4 slow tasks cancelled: %s\n", cancelled, (ok ? "ok" : "FAIL"));
+  assert(ok);
+#else
+  kk_unused(ctx);
+#endif
+}
+
+static kk_box_t test_task_print(kk_function_t fself, kk_context_t* ctx) {
+  kk_unused(fself);
+  kk_println(kk_string_alloc_dup_valid_utf8("from a task", ctx), ctx);
+  return kk_box_null;
+}
+
+// Must run last as it closes the console output buffers
+static void test_output_done(kk_context_t* ctx) {
+#if !defined(WIN32)
+  printf("console output of all threads is flushed at exit?\n");
+  fflush(stdout);
+  kk_define_static_function(print, test_task_print, ctx);
+  int fds[2];
+  bool ok = (pipe(fds) == 0);
+  const int saved = dup(1);
+  ok = ok && (saved >= 0) && (dup2(fds[1], 1) >= 0);
+  if (ok) {
+    kk_box_t result;
+    ok = (kk_promise_wait(kk_task_schedule(kk_function_dup(print), ctx), -1, &result, ctx) == KK_PROMISE_OK);
+    kk_output_done();  // as at process exit
+    kk_print(kk_string_alloc_dup_valid_utf8("after", ctx), ctx);  // written directly once closed
+    dup2(saved, 1);
+  }
+  char buf[128] = { 0 };
+  const char* expect = "from a task\nafter";
+  ok = ok && (read(fds[0], buf, sizeof(buf) - 1) == (ssize_t)strlen(expect)) && (strcmp(buf, expect) == 0);
+  if (saved >= 0) close(saved);
+  close(fds[0]);
+  close(fds[1]);
+  printf(" %s\n", (ok ? "ok" : "FAIL"));
+  assert(ok);
+#else
+  kk_unused(ctx);
+#endif
+}
+
 int main() {
   kk_context_t* ctx = kk_get_context();
   
@@ -579,6 +957,7 @@ int main() {
   test_addx(ctx);
   test_carry(ctx);
   test_large(ctx);
+  test_accumulate(ctx);
   test_cdiv(ctx);
   test_count(ctx);
   test_pow10(ctx);
@@ -588,6 +967,14 @@ int main() {
   test_count10(ctx);
   //test_popcount();
   test_bitcount();
+  test_process(ctx);
+  test_walk(ctx);
+  test_output(ctx);
+  test_bytes(ctx);
+  test_atomic_write(ctx);
+  test_cpu_info(ctx);
+  test_task_scope(ctx);
+  test_output_done(ctx);
   //test_random(ctx);
 
   /*
@@ -61,8 +61,44 @@ kk_std_core_hnd__ev kk_ev_none(kk_context_t* ctx) {
 }
 
 
+/*-----------------------------------------------------------------------
+  Profiling (enabled with --kkprofile)
+-----------------------------------------------------------------------*/
+
+static const char* kk_ev_tag_cbuf(kk_std_core_hnd__ev ev) {
+  return kk_string_cbuf_borrow(kk_std_core_hnd__as_Ev(ev)->htag.tagname, NULL);
+}
+
+// the tag name of the handler with marker `m` in the current evidence vector (or NULL)
+static const char* kk_evv_tag_of_marker(int32_t m, kk_context_t* ctx) {
+  kk_ssize_t len;
+  kk_std_core_hnd__ev single;
+  kk_std_core_hnd__ev* vec = kk_evv_as_vec(ctx->evv,&len,&single);
+  for(kk_ssize_t i = 0; i < len; i++) {
+    if (kk_std_core_hnd__as_Ev(vec[i])->marker.m == m) return kk_ev_tag_cbuf(vec[i]);
+  }
+  return NULL;
+}
+
+static void kk_prof_count_marker(int32_t m, kk_prof_event_t event, kk_context_t* ctx) {
+  if (kk_unlikely(kk_prof_enabled(ctx))) {
+    kk_prof_count(kk_evv_tag_of_marker(m,ctx), event, ctx);
+  }
+}
+
+void kk_evv_prof_at(kk_ssize_t i, kk_context_t* ctx) {
+  kk_ssize_t len;
+  kk_std_core_hnd__ev single;
+  kk_std_core_hnd__ev* vec = kk_evv_as_vec(ctx->evv,&len,&single);
+  kk_prof_count((i >= 0 && i < len ? kk_ev_tag_cbuf(vec[i]) : NULL), KK_PROF_OPERATION, ctx);
+}
+
+
 kk_ssize_t kk_evv_index( struct kk_std_core_hnd_Htag htag, kk_context_t* ctx ) {
   // todo: drop htag?
+  if (kk_unlikely(kk_prof_enabled(ctx))) {
+    kk_prof_count(kk_string_cbuf_borrow(htag.tagname,NULL), KK_PROF_LOOKUP, ctx);
+  }
   kk_ssize_t len;
   kk_std_core_hnd__ev single;
   kk_std_core_hnd__ev* vec = kk_evv_as_vec(ctx->evv,&len,&single);
@@ -144,6 +180,9 @@ kk_evv_t kk_evv_insert(kk_evv_t evvd, kk_std_core_hnd__ev evd, kk_context_t* ctx
   }
   else {
     // create evidence vector
+    if (kk_unlikely(kk_prof_enabled(ctx))) {
+      kk_prof_count(kk_ev_tag_cbuf(evd), KK_PROF_EVV_ALLOC, ctx);
+    }
     const int32_t cfc = kk_cfc_lub(kk_evv_cfc_of_borrow(evvd, ctx), ev->cfc);
     ev->cfc = cfc; // update in place
     kk_evv_vector_t vec2 = kk_evv_vector_alloc(n+1, cfc, ctx);
@@ -238,48 +277,121 @@ kk_string_t kk_evv_show(kk_evv_t evv, kk_context_t* ctx) {
 
 /*-----------------------------------------------------------------------
   Compose continuations
+
+  Most continuations are resumed at most once, in which case the
+  composition is unique: we then call each continuation without a dup,
+  reuse the composition in place if we yield again, and extend it in
+  place (instead of nesting) when the yield continuation array is full.
 -----------------------------------------------------------------------*/
 
 struct kcompose_fun_s {
   struct kk_function_s _base;
+  kk_box_t      capacity;
   kk_box_t      count;
   kk_function_t conts[1];
 };
 
+// keep the scan size (3 + count) within the small block header field
+#define KCOMPOSE_CAPACITY_MAX  (KK_SCAN_FSIZE_MAX - 4)
+
+static kk_box_t kcompose( kk_function_t fself, kk_box_t x, kk_context_t* ctx);
+
+static kk_ssize_t kcompose_size( kk_ssize_t capacity ) {
+  return kk_ssizeof(struct kcompose_fun_s) - kk_ssizeof(kk_function_t) + (capacity*kk_ssizeof(kk_function_t));
+}
+
+static kk_ssize_t kcompose_count( struct kcompose_fun_s* f ) {
+  return (kk_ssize_t)kk_intf_unbox(f->count);
+}
+
+static void kcompose_set_count( struct kcompose_fun_s* f, kk_ssize_t count ) {
+  kk_assert_internal(count <= (kk_ssize_t)kk_intf_unbox(f->capacity));
+  f->count = kk_intf_box(count);
+  f->_base._block.header.scan_fsize = (uint8_t)(3 + count);
+}
+
+static struct kcompose_fun_s* kcompose_alloc( kk_ssize_t capacity, kk_context_t* ctx ) {
+  kk_assert_internal(capacity > 0 && capacity <= KCOMPOSE_CAPACITY_MAX);
+  kk_prof_count_marker(ctx->yield.marker, KK_PROF_COMPOSE, ctx);
+  struct kcompose_fun_s* f = kk_block_as(struct kcompose_fun_s*,
+                               kk_block_alloc(kcompose_size(capacity), 3 /* scan size */, KK_TAG_FUNCTION, ctx));
+  f->_base.fun = kk_cfun_ptr_box(&kcompose,ctx);
+  f->capacity = kk_intf_box(capacity);
+  kcompose_set_count(f,0);
+  return f;
+}
+
+// append continuations (taking ownership) to a unique composition, growing it if needed
+static struct kcompose_fun_s* kcompose_append( struct kcompose_fun_s* f, kk_function_t* conts, kk_ssize_t n, kk_context_t* ctx ) {
+  const kk_ssize_t count = kcompose_count(f);
+  kk_ssize_t capacity = (kk_ssize_t)kk_intf_unbox(f->capacity);
+  kk_assert_internal(count + n <= KCOMPOSE_CAPACITY_MAX);
+  if (count + n > capacity) {
+    capacity = 2*capacity;
+    if (capacity < count + n) capacity = count + n;
+    if (capacity > KCOMPOSE_CAPACITY_MAX) capacity = KCOMPOSE_CAPACITY_MAX;
+    f = (struct kcompose_fun_s*)kk_block_realloc(&f->_base._block, kcompose_size(capacity), ctx);
+    f->capacity = kk_intf_box(capacity);
+  }
+  kk_memcpy(&f->conts[count], conts, n * kk_ssizeof(kk_function_t));
+  kcompose_set_count(f, count + n);
+  return f;
+}
+
+// return the composition if `f` is a unique composition (so it can be updated in place), or NULL otherwise
+static struct kcompose_fun_s* kcompose_as_unique( kk_function_t f ) {
+  if (!kk_function_is_unique(f)) return NULL;
+  if (kk_cfun_ptr_unbox(f->fun) != (kk_cfun_ptr_t)&kcompose) return NULL;
+  return kk_function_as(struct kcompose_fun_s*,f);
+}
+
 // kleisli composition of continuations
 static kk_box_t kcompose( kk_function_t fself, kk_box_t x, kk_context_t* ctx) {
   struct kcompose_fun_s* self = kk_function_as(struct kcompose_fun_s*,fself);
-  kk_intx_t count = kk_intf_unbox(self->count);
+  const kk_ssize_t count = kcompose_count(self);
   kk_function_t* conts = &self->conts[0];
+  // if unique, we own the continuations and can pass them on without a dup
+  const bool unique = kk_function_is_unique(fself);
   // call each continuation in order
-  for(kk_intx_t i = 0; i < count; i++) {
-    // todo: take uniqueness of fself into account to avoid dup_function
-    kk_function_t f = kk_function_dup(conts[i]);
+  for(kk_ssize_t i = 0; i < count; i++) {
+    kk_function_t f = (unique ? conts[i] : kk_function_dup(conts[i]));
     x = kk_function_call(kk_box_t, (kk_function_t, kk_box_t, kk_context_t*), f, (f, x, ctx));
     if (kk_yielding(ctx)) {
       // if yielding, `yield_next` all continuations that still need to be done
-      while(++i < count) {
-        // todo: if fself is unique, we could copy without dup?
-        kk_yield_extend(kk_function_dup(conts[i]),ctx);
+      const kk_ssize_t rest = count - i - 1;
+      if (!unique) {
+        while(++i < count) {
+          kk_yield_extend(kk_function_dup(conts[i]),ctx);
+        }
+        kk_function_drop(fself,ctx);
+      }
+      else if (rest == 0) {
+        kk_block_free(&fself->_block,ctx);  // all continuations are consumed
+      }
+      else {
+        // reuse this composition in place for the remaining continuations
+        kk_memmove(&conts[0], &conts[i+1], rest * kk_ssizeof(kk_function_t));
+        kcompose_set_count(self, rest);
+        kk_yield_extend(fself,ctx);
       }
-      kk_function_drop(fself,ctx);
       kk_box_drop(x,ctx);     // still drop even though we yield as it may release a boxed value type?
       return kk_box_any(ctx); // return yielding
     }
   }
-  kk_function_drop(fself,ctx);
+  if (unique) {
+    kk_block_free(&fself->_block,ctx);  // all continuations are consumed
+  }
+  else {
+    kk_function_drop(fself,ctx);
+  }
   return x;
 }
 
 static kk_function_t new_kcompose( kk_function_t* conts, kk_ssize_t count, kk_context_t* ctx ) {
   if (count==0) return kk_function_id(ctx);
   if (count==1) return conts[0];
-  struct kcompose_fun_s* f = kk_block_as(struct kcompose_fun_s*,
-                               kk_block_alloc(kk_ssizeof(struct kcompose_fun_s) - kk_ssizeof(kk_function_t) + (count*kk_ssizeof(kk_function_t)),
-                                 2 + count /* scan size */, KK_TAG_FUNCTION, ctx));
-  f->_base.fun = kk_cfun_ptr_box(&kcompose,ctx);
-  f->count = kk_intf_box(count);
-  kk_memcpy(f->conts, conts, count * kk_ssizeof(kk_function_t));
+  struct kcompose_fun_s* f = kcompose_alloc(count,ctx);
+  f = kcompose_append(f, conts, count, ctx);
   return (&f->_base);
 }
 
@@ -290,15 +402,24 @@ static kk_function_t new_kcompose( kk_function_t* conts, kk_ssize_t count, kk_co
 kk_box_t kk_yield_extend( kk_function_t next, kk_context_t* ctx ) {
   kk_yield_t* yield = &ctx->yield;
   kk_assert_internal(kk_yielding(ctx));  // cannot extend if not yielding
+  kk_prof_count_marker(yield->marker, KK_PROF_EXTEND, ctx);
   if (kk_unlikely(kk_yielding_final(ctx))) {
     // todo: can we optimize this so `next` is never allocated in the first place?
     kk_function_drop(next,ctx); // ignore extension if never resuming
   }
   else {
     if (kk_unlikely(yield->conts_count >= KK_YIELD_CONT_MAX)) {
-      // alloc a function to compose all continuations in the array
-      kk_function_t comp = new_kcompose( yield->conts, yield->conts_count, ctx );
-      yield->conts[0] = comp;
+      // compose all continuations in the array; if the first one is already a unique
+      // composition (as when yielding repeatedly through deep stacks) we extend it in place
+      struct kcompose_fun_s* comp = kcompose_as_unique(yield->conts[0]);
+      if (comp != NULL && kcompose_count(comp) + yield->conts_count - 1 <= KCOMPOSE_CAPACITY_MAX) {
+        comp = kcompose_append(comp, &yield->conts[1], yield->conts_count - 1, ctx);
+      }
+      else {
+        comp = kcompose_alloc(4*KK_YIELD_CONT_MAX, ctx);
+        comp = kcompose_append(comp, yield->conts, yield->conts_count, ctx);
+      }
+      yield->conts[0] = &comp->_base;
       yield->conts_count = 1;
     }
     yield->conts[yield->conts_count++] = next;
@@ -351,6 +472,7 @@ kk_function_t kk_yield_to( struct kk_std_core_hnd_Marker m, kk_function_t clause
   yield->marker = m.m;
   yield->clause = clause;
   yield->conts_count = 0;
+  kk_prof_count_marker(m.m, KK_PROF_YIELD, ctx);
   return kk_basetype_unbox_as(kk_function_t,kk_box_any(ctx));
 }
 
@@ -48,8 +48,11 @@ static inline kk_evv_vector_t kk_evv_as_vector( kk_evv_t evv ) {
   return (kk_evv_vector_t)evv;
 }
 
+void kk_evv_prof_at(kk_ssize_t i, kk_context_t* ctx);
+
 static inline struct kk_std_core_hnd__ev_s* kk_evv_at( kk_ssize_t i, kk_context_t* ctx ) {
   kk_evv_t evv = ctx->evv;
+  if (kk_unlikely(kk_prof_enabled(ctx))) { kk_evv_prof_at(i,ctx); }
   if (!kk_evv_is_vector(evv)) {  // evv is a single evidence
     kk_assert_internal(i==0);
     return kk_evv_as_ev(kk_evv_dup(evv));
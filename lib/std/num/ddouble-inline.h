@@ -0,0 +1,94 @@
+/*---------------------------------------------------------------------------
+  Copyright 2021, Microsoft Research, Daan Leijen.
+
+  This is free software; you can redistribute it and/or modify it under the
+  terms of the Apache License, Version 2.0. A copy of the License can be
+  found in the LICENSE file at the root of this distribution.
+---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------
+  Batched double-double kernels over vectors of doubles.
+  We use error-free transformations (two-sum and an `fma` based two-product)
+  and accumulate the errors separately ("Sum2" and "Dot2" of Ogita, Rump, and Oishi),
+  which gives a result as accurate as if computed in double-double precision.
+  The loops use independent lanes so the C compiler can vectorize and pipeline them.
+---------------------------------------------------------------------------*/
+
+#define KK_DD_LANES  (4)
+
+static inline double kk_dd_two_sum(double x, double y, double* err) {
+  const double z    = x + y;
+  const double diff = z - x;
+  *err = (x - (z - diff)) + (y - diff);
+  return z;
+}
+
+static inline double kk_dd_two_prod(double x, double y, double* err) {
+  const double z = x * y;
+  *err = fma(x, y, -z);
+  return z;
+}
+
+// combine the partial sums and errors of all lanes into a `:ddouble` (as `dquicksum`)
+static inline kk_std_num_ddouble__ddouble kk_dd_lanes_result(const double* p, const double* s, kk_context_t* ctx) {
+  double hi = p[0];
+  double lo = s[0];
+  for (int j = 1; j < KK_DD_LANES; j++) {
+    double err;
+    hi = kk_dd_two_sum(hi, p[j], &err);
+    lo += err + s[j];
+  }
+  if (!isfinite(hi)) return kk_std_num_ddouble__new_Ddouble(hi, 0.0, ctx);
+  const double z   = hi + lo;
+  const double err = lo - (z - hi);
+  return kk_std_num_ddouble__new_Ddouble(z, (isfinite(z) ? err : z), ctx);
+}
+
+static inline kk_std_num_ddouble__ddouble kk_ddouble_vector_sum(kk_vector_t v, kk_context_t* ctx) {
+  kk_ssize_t n;
+  const kk_box_t* xs = kk_vector_buf_borrow(v, &n);
+  double p[KK_DD_LANES] = { 0.0 };
+  double s[KK_DD_LANES] = { 0.0 };
+  kk_ssize_t i = 0;
+  for (; i + KK_DD_LANES <= n; i += KK_DD_LANES) {
+    for (int j = 0; j < KK_DD_LANES; j++) {
+      double err;
+      p[j] = kk_dd_two_sum(p[j], kk_double_unbox(xs[i+j], NULL), &err);
+      s[j] += err;
+    }
+  }
+  for (int j = 0; i < n; i++, j++) {
+    double err;
+    p[j] = kk_dd_two_sum(p[j], kk_double_unbox(xs[i], NULL), &err);
+    s[j] += err;
+  }
+  return kk_dd_lanes_result(p, s, ctx);
+}
+
+static inline kk_std_num_ddouble__ddouble kk_ddouble_vector_dot(kk_vector_t v, kk_vector_t w, kk_context_t* ctx) {
+  kk_ssize_t n;
+  kk_ssize_t m;
+  const kk_box_t* xs = kk_vector_buf_borrow(v, &n);
+  const kk_box_t* ys = kk_vector_buf_borrow(w, &m);
+  if (m < n) n = m;
+  double p[KK_DD_LANES] = { 0.0 };
+  double s[KK_DD_LANES] = { 0.0 };
+  kk_ssize_t i = 0;
+  for (; i + KK_DD_LANES <= n; i += KK_DD_LANES) {
+    for (int j = 0; j < KK_DD_LANES; j++) {
+      double perr;
+      double serr;
+      const double h = kk_dd_two_prod(kk_double_unbox(xs[i+j], NULL), kk_double_unbox(ys[i+j], NULL), &perr);
+      p[j] = kk_dd_two_sum(p[j], h, &serr);
+      s[j] += serr + perr;
+    }
+  }
+  for (int j = 0; i < n; i++, j++) {
+    double perr;
+    double serr;
+    const double h = kk_dd_two_prod(kk_double_unbox(xs[i], NULL), kk_double_unbox(ys[i], NULL), &perr);
+    p[j] = kk_dd_two_sum(p[j], h, &serr);
+    s[j] += serr + perr;
+  }
+  return kk_dd_lanes_result(p, s, ctx);
+}
@@ -0,0 +1,54 @@
+/*---------------------------------------------------------------------------
+  Copyright 2021, Microsoft Research, Daan Leijen.
+
+  This is free software; you can redistribute it and/or modify it under the
+  terms of the Apache License, Version 2.0. A copy of the License can be
+  found in the LICENSE file at the root of this distribution.
+---------------------------------------------------------------------------*/
+
+// See `ddouble-inline.h` for the C versions of these kernels.
+
+var _dd_splitter = Math.pow(2,27) + 1;
+
+function _dd_two_prod_err(x,y,z) {
+  var t   = x * _dd_splitter;
+  var xhi = t - (t - x);
+  var xlo = x - xhi;
+  t = y * _dd_splitter;
+  var yhi = t - (t - y);
+  var ylo = y - yhi;
+  return ((xhi*yhi - z) + (xhi*ylo + xlo*yhi)) + (xlo*ylo);
+}
+
+function _dd_result(p,s) {
+  if (!isFinite(p)) return { hi: p, lo: 0.0 };
+  var z   = p + s;
+  var err = s - (z - p);
+  return { hi: z, lo: (isFinite(z) ? err : z) };
+}
+
+function _ddouble_vector_sum(v) {
+  var p = 0.0;
+  var s = 0.0;
+  for(var i = 0; i < v.length; i++) {
+    var z    = p + v[i];
+    var diff = z - p;
+    s += (p - (z - diff)) + (v[i] - diff);
+    p = z;
+  }
+  return _dd_result(p,s);
+}
+
+function _ddouble_vector_dot(v,w) {
+  var n = Math.min(v.length,w.length);
+  var p = 0.0;
+  var s = 0.0;
+  for(var i = 0; i < n; i++) {
+    var h    = v[i] * w[i];
+    var z    = p + h;
+    var diff = z - p;
+    s += ((p - (z - diff)) + (h - diff)) + _dd_two_prod_err(v[i],w[i],h);
+    p = z;
+  }
+  return _dd_result(p,s);
+}
@@ -25,3 +25,60 @@ static kk_std_core__error kk_os_list_directory_prim( kk_string_t dir, kk_context
   if (err != 0) return kk_error_from_errno(err,ctx);
            else return kk_error_ok(kk_vector_box(contents,ctx),ctx);
 }
+
+// A directory walk together with its current entry.
+typedef struct kk_os_walk_iter_s {
+  kk_os_walk_t* walk;
+  const char*   path;   // current entry (valid until the next call to `kk_os_walk_next`)
+  char          kind;
+} kk_os_walk_iter_t;
+
+static void kk_os_walk_free_fun( void* p, kk_block_t* b, kk_context_t* ctx ) {
+  kk_unused(b);
+  kk_os_walk_iter_t* iter = (kk_os_walk_iter_t*)p;
+  kk_os_walk_free(iter->walk,ctx);
+  kk_free(iter,ctx);
+}
+
+// Start a walk; returns `Nothing` if there is no native walker on this platform.
+static kk_std_core__error kk_os_walk_directory_prim( kk_string_t dir, kk_integer_t max_depth, bool skip_hidden, kk_context_t* ctx ) {
+  kk_os_walk_t* walk = NULL;
+  const int err = kk_os_walk_directory(dir,kk_integer_clamp_ssize_t(max_depth,ctx),skip_hidden,&walk,ctx);
+  if (err == ENOSYS) return kk_error_ok(kk_std_core_types__maybe_box(kk_std_core_types__new_Nothing(ctx),ctx),ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+  kk_os_walk_iter_t* iter = (kk_os_walk_iter_t*)kk_zalloc(kk_ssizeof(kk_os_walk_iter_t),ctx);
+  iter->walk = walk;
+  kk_std_core_types__maybe res = kk_std_core_types__new_Just(kk_cptr_raw_box(&kk_os_walk_free_fun,iter,ctx),ctx);
+  return kk_error_ok(kk_std_core_types__maybe_box(res,ctx),ctx);
+}
+
+// Advance to the next entry; returns `false` at the end of the walk.
+static bool kk_os_walk_next_prim( kk_box_t bwalk, kk_context_t* ctx ) {
+  kk_os_walk_iter_t* iter = (kk_os_walk_iter_t*)kk_cptr_raw_unbox(bwalk);
+  iter->path = kk_os_walk_next(iter->walk,&iter->kind);
+  const bool found = (iter->path != NULL);
+  kk_box_drop(bwalk,ctx);
+  return found;
+}
+
+// Check at the end of a walk whether all entries were visited.
+static kk_std_core__error kk_os_walk_error_prim( kk_box_t bwalk, kk_context_t* ctx ) {
+  kk_os_walk_iter_t* iter = (kk_os_walk_iter_t*)kk_cptr_raw_unbox(bwalk);
+  const int err = kk_os_walk_error(iter->walk);
+  kk_box_drop(bwalk,ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+           else return kk_error_ok(kk_unit_box(kk_Unit),ctx);
+}
+
+static kk_string_t kk_os_walk_path_prim( kk_box_t bwalk, kk_context_t* ctx ) {
+  const char* path = ((kk_os_walk_iter_t*)kk_cptr_raw_unbox(bwalk))->path;
+  kk_string_t s = (path == NULL ? kk_string_empty() : kk_string_alloc_from_qutf8(path,ctx));
+  kk_box_drop(bwalk,ctx);
+  return s;
+}
+
+static bool kk_os_walk_is_dir_prim( kk_box_t bwalk, kk_context_t* ctx ) {
+  const char kind = ((kk_os_walk_iter_t*)kk_cptr_raw_unbox(bwalk))->kind;
+  kk_box_drop(bwalk,ctx);
+  return (kind == 'd');
+}
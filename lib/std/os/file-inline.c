@@ -18,3 +18,85 @@ static kk_std_core__error kk_os_write_text_file_error( kk_string_t path, kk_stri
   if (err != 0) return kk_error_from_errno(err,ctx);
            else return kk_error_ok(kk_unit_box(kk_Unit),ctx);
 }
+
+static kk_std_core__error kk_os_write_text_file_atomic_error( kk_string_t path, kk_vector_t contents, int32_t fsync_policy, kk_context_t* ctx ) {
+  const int err = kk_os_write_text_file_atomic(path,contents,(kk_os_fsync_t)fsync_policy,ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+           else return kk_error_ok(kk_unit_box(kk_Unit),ctx);
+}
+
+/*--------------------------------------------------------------------------------------------------
+  Binary files
+--------------------------------------------------------------------------------------------------*/
+
+static kk_box_t kk_os_bytes_from_string( kk_string_t s, kk_context_t* ctx ) {
+  kk_unused(ctx);
+  return kk_bytes_box(s.bytes);
+}
+
+static kk_string_t kk_os_bytes_to_string( kk_box_t b, kk_context_t* ctx ) {
+  return kk_string_convert_from_qutf8(kk_bytes_unbox(b),ctx);
+}
+
+static kk_ssize_t kk_os_bytes_length( kk_box_t b, kk_context_t* ctx ) {
+  return kk_bytes_len(kk_bytes_unbox(b),ctx);
+}
+
+static kk_std_core__error kk_os_read_bytes_error( kk_string_t path, kk_context_t* ctx ) {
+  kk_bytes_t content;
+  const int err = kk_os_read_bytes(path,&content,ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+           else return kk_error_ok(kk_bytes_box(content),ctx);
+}
+
+static kk_std_core__error kk_os_write_bytes_error( kk_string_t path, kk_vector_t chunks, bool append, kk_context_t* ctx ) {
+  const int err = kk_os_write_bytes(path,chunks,append,ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+           else return kk_error_ok(kk_unit_box(kk_Unit),ctx);
+}
+
+static void kk_os_file_free_fun( void* p, kk_block_t* b, kk_context_t* ctx ) {
+  kk_unused(b);
+  kk_os_file_free((kk_os_file_t*)p,ctx);
+}
+
+static kk_std_core__error kk_os_file_open_error( kk_string_t path, bool write, bool create, kk_context_t* ctx ) {
+  kk_os_file_t* file = NULL;
+  const int err = kk_os_file_open(path,write,create,&file,ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+           else return kk_error_ok(kk_cptr_raw_box(&kk_os_file_free_fun,file,ctx),ctx);
+}
+
+static kk_std_core__error kk_os_file_size_error( kk_box_t bfile, kk_context_t* ctx ) {
+  kk_os_file_t* file = (kk_os_file_t*)kk_cptr_raw_unbox(bfile);
+  int64_t size = 0;
+  const int err = kk_os_file_size(file,&size);
+  kk_box_drop(bfile,ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+           else return kk_error_ok(kk_integer_box(kk_integer_from_int64(size,ctx)),ctx);
+}
+
+static kk_std_core__error kk_os_file_pread_error( kk_box_t bfile, int64_t offset, kk_ssize_t len, kk_context_t* ctx ) {
+  kk_os_file_t* file = (kk_os_file_t*)kk_cptr_raw_unbox(bfile);
+  kk_bytes_t content;
+  const int err = kk_os_file_pread(file,offset,len,&content,ctx);
+  kk_box_drop(bfile,ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+           else return kk_error_ok(kk_bytes_box(content),ctx);
+}
+
+static kk_std_core__error kk_os_file_pwrite_error( kk_box_t bfile, int64_t offset, kk_vector_t chunks, kk_context_t* ctx ) {
+  kk_os_file_t* file = (kk_os_file_t*)kk_cptr_raw_unbox(bfile);
+  const int err = kk_os_file_pwrite(file,offset,chunks,ctx);
+  kk_box_drop(bfile,ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+           else return kk_error_ok(kk_unit_box(kk_Unit),ctx);
+}
+
+static kk_std_core__error kk_os_file_close_error( kk_box_t bfile, kk_context_t* ctx ) {
+  kk_os_file_t* file = (kk_os_file_t*)kk_cptr_raw_unbox(bfile);
+  const int err = kk_os_file_close(file);
+  kk_box_drop(bfile,ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+           else return kk_error_ok(kk_unit_box(kk_Unit),ctx);
+}
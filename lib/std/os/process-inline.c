@@ -17,3 +17,63 @@ static kk_integer_t kk_os_run_system_prim( kk_string_t cmd, kk_context_t* ctx )
   const int exitcode = kk_os_run_system(cmd,ctx);
   return kk_integer_from_int(exitcode,ctx);
 }
+
+static void kk_os_process_free_fun( void* p, kk_block_t* b, kk_context_t* ctx ) {
+  kk_unused(b);
+  kk_os_process_free((kk_os_process_t*)p,ctx);
+}
+
+static kk_std_core__error kk_os_process_spawn_error( kk_vector_t argv, kk_string_t input, kk_context_t* ctx ) {
+  kk_os_process_t* proc = NULL;
+  const int err = kk_os_process_spawn(argv,input,&proc,ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+           else return kk_error_ok(kk_cptr_raw_box(&kk_os_process_free_fun,proc,ctx),ctx);
+}
+
+// Returns `Just((is-stderr,line))` or `Nothing` at the end of the output.
+static kk_std_core__error kk_os_process_read_line_error( kk_box_t bproc, kk_context_t* ctx ) {
+  kk_os_process_t* proc = (kk_os_process_t*)kk_cptr_raw_unbox(bproc);
+  bool is_stderr;
+  bool eof;
+  kk_string_t line;
+  const int err = kk_os_process_read_line(proc,&is_stderr,&line,&eof,ctx);
+  kk_box_drop(bproc,ctx);
+  if (err != 0) {
+    kk_string_drop(line,ctx);
+    return kk_error_from_errno(err,ctx);
+  }
+  kk_std_core_types__maybe res;
+  if (eof) {
+    kk_string_drop(line,ctx);
+    res = kk_std_core_types__new_Nothing(ctx);
+  }
+  else {
+    kk_std_core_types__tuple2_ tup = kk_std_core_types__new_dash__lp__comma__rp_( kk_bool_box(is_stderr), kk_string_box(line), ctx );
+    res = kk_std_core_types__new_Just( kk_std_core_types__tuple2__box(tup,ctx), ctx );
+  }
+  return kk_error_ok(kk_std_core_types__maybe_box(res,ctx),ctx);
+}
+
+static kk_std_core__error kk_os_process_read_all_error( kk_box_t bproc, kk_context_t* ctx ) {
+  kk_os_process_t* proc = (kk_os_process_t*)kk_cptr_raw_unbox(bproc);
+  kk_string_t out;
+  kk_string_t errout;
+  const int err = kk_os_process_read_all(proc,&out,&errout,ctx);
+  kk_box_drop(bproc,ctx);
+  if (err != 0) {
+    kk_string_drop(out,ctx);
+    kk_string_drop(errout,ctx);
+    return kk_error_from_errno(err,ctx);
+  }
+  kk_std_core_types__tuple2_ tup = kk_std_core_types__new_dash__lp__comma__rp_( kk_string_box(out), kk_string_box(errout), ctx );
+  return kk_error_ok(kk_std_core_types__tuple2__box(tup,ctx),ctx);
+}
+
+static kk_std_core__error kk_os_process_wait_error( kk_box_t bproc, kk_context_t* ctx ) {
+  kk_os_process_t* proc = (kk_os_process_t*)kk_cptr_raw_unbox(bproc);
+  int exitcode = 0;
+  const int err = kk_os_process_wait(proc,&exitcode,ctx);
+  kk_box_drop(bproc,ctx);
+  if (err != 0) return kk_error_from_errno(err,ctx);
+           else return kk_error_ok(kk_integer_box(kk_integer_from_int(exitcode,ctx)),ctx);
+}
@@ -0,0 +1,47 @@
+/*---------------------------------------------------------------------------
+  Copyright 2021-2021, Microsoft Research, Daan Leijen.
+
+  This is free software; you can redistribute it and/or modify it under the
+  terms of the Apache License, Version 2.0. A copy of the License can be
+  found in the LICENSE file at the root of this distribution.
+---------------------------------------------------------------------------*/
+
+// Returns a vector of the task statistics in the order of the fields of `task-stats`.
+static kk_vector_t kk_task_stats_vector( kk_context_t* ctx ) {
+  kk_task_stats_t stats;
+  kk_task_stats(&stats,ctx);
+  const kk_ssize_t fields[9] = { stats.cpu.host_count, stats.cpu.affinity_count, stats.cpu.quota_count, stats.cpu.available,
+                                 stats.cpu.numa_nodes, stats.thread_count, stats.queue_count, stats.queued, stats.tasks_run };
+  kk_box_t* buf;
+  kk_vector_t v = kk_vector_alloc_uninit(9,&buf,ctx);
+  for (int i = 0; i < 9; i++) {
+    buf[i] = kk_integer_box(kk_integer_from_ssize_t(fields[i],ctx));
+  }
+  return v;
+}
+
+// Returns `(index,Just(result))` on success, or `(-1,Nothing)` on a timeout, and `(-2,Nothing)` if cancelled.
+static kk_std_core_types__tuple2_ kk_task_await_tuple( kk_promise_status_t status, kk_ssize_t index, kk_box_t result, kk_context_t* ctx ) {
+  kk_std_core_types__maybe m;
+  if (status == KK_PROMISE_OK) {
+    m = kk_std_core_types__new_Just(result,ctx);
+  }
+  else {
+    m = kk_std_core_types__new_Nothing(ctx);
+    index = (status == KK_PROMISE_TIMEOUT ? -1 : -2);
+  }
+  return kk_std_core_types__new_dash__lp__comma__rp_( kk_integer_box(kk_integer_from_ssize_t(index,ctx)), kk_std_core_types__maybe_box(m,ctx), ctx );
+}
+
+static kk_std_core_types__tuple2_ kk_task_await_prim( kk_promise_t p, int64_t timeout, kk_context_t* ctx ) {
+  kk_box_t result;
+  const kk_promise_status_t status = kk_promise_wait(p,timeout,&result,ctx);
+  return kk_task_await_tuple(status,0,result,ctx);
+}
+
+static kk_std_core_types__tuple2_ kk_task_await_any_prim( kk_vector_t ps, int64_t timeout, kk_context_t* ctx ) {
+  kk_box_t result;
+  kk_ssize_t index = -1;
+  const kk_promise_status_t status = kk_promise_wait_any(ps,timeout,&index,&result,ctx);
+  return kk_task_await_tuple(status,index,result,ctx);
+}
@@ -42,7 +42,10 @@ static void kk_regex_custom_init( kk_context_t* ctx ) {
   }
 }
 
+static void kk_regex_cache_clear( kk_context_t* ctx );
+
 static void kk_regex_custom_done( kk_context_t* ctx ) {
+  kk_regex_cache_clear(ctx);
   if (cmp_ctx != NULL) {
     pcre2_compile_context_free(cmp_ctx);
     cmp_ctx = NULL;
@@ -58,33 +61,183 @@ static void kk_regex_custom_done( kk_context_t* ctx ) {
 }
 
 
+/* -----------------------------------------------------------------------
+  A small pool of match data (or other scratch space) per regex, so that
+  concurrent matches on a regex shared between threads each reuse their
+  own instead of allocating it on every call. A thread takes an entry out
+  of the pool while matching (so it is never used by two threads at the
+  same time) and starts searching at a slot based on its thread id.
+------------------------------------------------------------------------*/
+
+#define KK_REGEX_POOL_SIZE  (8)
+
+typedef struct kk_regex_pool_s {
+  _Atomic(void*) slots[KK_REGEX_POOL_SIZE];
+} kk_regex_pool_t;
+
+static kk_ssize_t kk_regex_pool_home( kk_context_t* ctx ) {
+  // the thread id is the address of a thread local, so mix its bits
+  const uint64_t h = (uint64_t)ctx->thread_id * KK_U64(0x9E3779B97F4A7C15);
+  return (kk_ssize_t)((h >> 32) % KK_REGEX_POOL_SIZE);
+}
+
+static void* kk_regex_pool_take( kk_regex_pool_t* pool, kk_context_t* ctx ) {
+  const kk_ssize_t home = kk_regex_pool_home(ctx);
+  for (kk_ssize_t i = 0; i < KK_REGEX_POOL_SIZE; i++) {
+    void* p = kk_atomic_exchange_acq_rel(&pool->slots[(home + i) % KK_REGEX_POOL_SIZE], (void*)NULL);
+    if (p != NULL) return p;
+  }
+  return NULL;
+}
+
+// Put back an entry; returns `false` if the pool is full (and the entry should be freed).
+static bool kk_regex_pool_put( kk_regex_pool_t* pool, void* p, kk_context_t* ctx ) {
+  const kk_ssize_t home = kk_regex_pool_home(ctx);
+  for (kk_ssize_t i = 0; i < KK_REGEX_POOL_SIZE; i++) {
+    void* expected = NULL;
+    if (kk_atomic_cas_strong_acq_rel(&pool->slots[(home + i) % KK_REGEX_POOL_SIZE], &expected, p)) return true;
+  }
+  return false;
+}
+
+
 /* -----------------------------------------------------------------------
   Compile
 ------------------------------------------------------------------------*/
 
+// A compiled regular expression with a pool of match data.
+typedef struct kk_regex_s {
+  pcre2_code*     code;
+  kk_regex_pool_t match_data;
+} kk_regex_t;
+
 static void kk_regex_free( void* pre, kk_block_t* b, kk_context_t* ctx ) {
-  kk_unused(ctx);
-  pcre2_code* re = (pcre2_code*)pre;
+  kk_unused(b);
+  kk_regex_t* re = (kk_regex_t*)pre;
   //kk_info_message( "free regex at %p\n", re );
-  if (re != NULL) pcre2_code_free(re);
+  if (re == NULL) return;
+  pcre2_match_data* md;
+  while ((md = (pcre2_match_data*)kk_regex_pool_take(&re->match_data, ctx)) != NULL) {
+    pcre2_match_data_free(md);
+  }
+  if (re->code != NULL) pcre2_code_free(re->code);
+  kk_free(re,ctx);
 }
 
 #define KK_REGEX_OPTIONS  (PCRE2_ALT_BSUX | PCRE2_EXTRA_ALT_BSUX | PCRE2_MATCH_UNSET_BACKREF /* javascript compat */ \
                           | PCRE2_NEVER_BACKSLASH_C | PCRE2_NEVER_UCP | PCRE2_UTF /* utf-8 safety */ \
                           )
 
+static kk_box_t kk_regex_compile( kk_string_t pat_borrow, uint32_t options, kk_context_t* ctx ) {
+  const uint8_t* cpat = kk_string_buf_borrow( pat_borrow, NULL );
+  PCRE2_SIZE errofs = 0;
+  int        errnum = 0;
+  pcre2_code* code = pcre2_compile( cpat, PCRE2_ZERO_TERMINATED, options, &errnum, &errofs, cmp_ctx);
+  //kk_info_message( "create regex: err:%i, at %p\n", (code==NULL ? 0 : errnum), code );
+  kk_regex_t* re = NULL;
+  if (code != NULL) {
+    // use the JIT if available; if it is not (or fails) `pcre2_match` uses the interpreter
+    pcre2_jit_compile( code, PCRE2_JIT_COMPLETE );
+    re = (kk_regex_t*)kk_zalloc( kk_ssizeof(kk_regex_t), ctx );
+    re->code = code;
+  }
+  return kk_cptr_raw_box( &kk_regex_free, re, ctx );
+}
+
+
+/* -----------------------------------------------------------------------
+  Compile cache: `regex(...)` is often called with the same pattern
+  in a loop, so we keep a small cache of compiled regexes. The cache is
+  shared by all threads (so the done hook releases every entry) and
+  guarded by a spin lock as it is only held for a lookup or an update.
+  The cached regexes are marked as shared since any thread can use them.
+------------------------------------------------------------------------*/
+
+#define KK_REGEX_CACHE_SIZE  (64)
+
+typedef struct kk_regex_cache_entry_s {
+  uint8_t*    pat;        // NULL if the entry is not used
+  kk_ssize_t  len;
+  uint32_t    options;
+  kk_box_t    re;
+} kk_regex_cache_entry_t;
+
+static kk_regex_cache_entry_t kk_regex_cache[KK_REGEX_CACHE_SIZE];
+static _Atomic(uintptr_t)     kk_regex_cache_lock;
+
+static void kk_regex_cache_enter( void ) {
+  uintptr_t expected = 0;
+  while (!kk_atomic_cas_weak_acq_rel(&kk_regex_cache_lock, &expected, 1)) {
+    expected = 0;
+  }
+}
+
+static void kk_regex_cache_leave( void ) {
+  kk_atomic_store_release(&kk_regex_cache_lock, 0);
+}
+
+static kk_regex_cache_entry_t* kk_regex_cache_entry( const uint8_t* cpat, kk_ssize_t len, uint32_t options ) {
+  uint32_t h = 2166136261U ^ options;   // FNV-1a
+  for (kk_ssize_t i = 0; i < len; i++) {
+    h = (h ^ cpat[i]) * 16777619U;
+  }
+  return &kk_regex_cache[h % KK_REGEX_CACHE_SIZE];
+}
+
+static void kk_regex_cache_clear( kk_context_t* ctx ) {
+  for (kk_ssize_t i = 0; i < KK_REGEX_CACHE_SIZE; i++) {
+    kk_regex_cache_enter();
+    kk_regex_cache_entry_t* entry = &kk_regex_cache[i];
+    uint8_t* pat = entry->pat;
+    kk_box_t re  = entry->re;
+    entry->pat = NULL;
+    kk_regex_cache_leave();
+    if (pat != NULL) {
+      kk_free(pat,ctx);
+      kk_box_drop(re,ctx);
+    }
+  }
+}
+
 static kk_box_t kk_regex_create( kk_string_t pat, bool ignore_case, bool multi_line, kk_context_t* ctx ) {
   kk_ssize_t len;
   const uint8_t* cpat = kk_string_buf_borrow( pat, &len );
-  PCRE2_SIZE errofs = 0;
-  int        errnum = 0;
   uint32_t   options = KK_REGEX_OPTIONS;
   if (ignore_case) options |= PCRE2_CASELESS;
   if (multi_line)  options |= PCRE2_MULTILINE;
-  pcre2_code* re = pcre2_compile( cpat, PCRE2_ZERO_TERMINATED, options, &errnum, &errofs, cmp_ctx);
-  //kk_info_message( "create regex: err:%i, at %p\n", (re==NULL ? 0 : errnum), re );
+  kk_regex_cache_entry_t* entry = kk_regex_cache_entry(cpat, len, options);
+  kk_box_t re = kk_box_null;
+  bool found = false;
+  kk_regex_cache_enter();
+  if (entry->pat != NULL && entry->options == options && entry->len == len && memcmp(entry->pat, cpat, kk_to_size_t(len)) == 0) {
+    re = kk_box_dup(entry->re);
+    found = true;
+  }
+  kk_regex_cache_leave();
+  if (found) {
+    kk_string_drop(pat,ctx);
+    return re;
+  }
+  // compile outside the lock and replace the entry
+  re = kk_regex_compile( pat, options, ctx );
+  kk_box_mark_shared(re,ctx);
+  uint8_t* epat = (uint8_t*)kk_malloc( len + 1, ctx );
+  memcpy(epat, cpat, kk_to_size_t(len));
+  epat[len] = 0;
   kk_string_drop(pat,ctx);
-  return kk_cptr_raw_box( &kk_regex_free, re, ctx );
+  kk_regex_cache_enter();
+  uint8_t* old_pat = entry->pat;
+  kk_box_t old_re  = entry->re;
+  entry->pat     = epat;
+  entry->len     = len;
+  entry->options = options;
+  entry->re      = kk_box_dup(re);
+  kk_regex_cache_leave();
+  if (old_pat != NULL) {
+    kk_free(old_pat,ctx);
+    kk_box_drop(old_re,ctx);
+  }
+  return re;
 }
 
 
@@ -100,6 +253,28 @@ static void kk_match_data_free( void* pmd, kk_block_t* b ) {
 }
 */
 
+static pcre2_match_data* kk_regex_match_data_acquire( kk_regex_t* re, kk_context_t* ctx ) {
+  pcre2_match_data* md = (pcre2_match_data*)kk_regex_pool_take(&re->match_data, ctx);
+  if (md == NULL) { md = pcre2_match_data_create_from_pattern(re->code, gen_ctx); }
+  return md;
+}
+
+static void kk_regex_match_data_release( kk_regex_t* re, pcre2_match_data* md, kk_context_t* ctx ) {
+  if (md == NULL) return;
+  if (!kk_regex_pool_put(&re->match_data, md, ctx)) {
+    pcre2_match_data_free(md);  // other threads put back their match data already
+  }
+}
+
+static int kk_regex_match( pcre2_code* code, const uint8_t* cstr, kk_ssize_t len, kk_ssize_t start, uint32_t options, pcre2_match_data* match_data ) {
+  int rc = pcre2_match( code, cstr, (PCRE2_SIZE)len, (PCRE2_SIZE)start, options, match_data, match_ctx );
+  if (rc == PCRE2_ERROR_JIT_STACKLIMIT) {
+    // the default JIT stack is small; fall back to the interpreter
+    rc = pcre2_match( code, cstr, (PCRE2_SIZE)len, (PCRE2_SIZE)start, options | PCRE2_NO_JIT, match_data, match_ctx );
+  }
+  return rc;
+}
+
 static kk_std_core__list kk_regex_exec_ex( pcre2_code* re, pcre2_match_data* match_data, 
                                            kk_string_t str_borrow, const uint8_t* cstr, kk_ssize_t len, bool allow_empty, 
                                            kk_ssize_t start, kk_ssize_t* mstart, kk_ssize_t* end, int* res, kk_context_t* ctx ) 
@@ -108,7 +283,7 @@ static kk_std_core__list kk_regex_exec_ex( pcre2_code* re, pcre2_match_data* mat
   kk_std_core__list hd  = kk_std_core__new_Nil(ctx);
   uint32_t options = 0;
   if (!allow_empty) options |= (PCRE2_NOTEMPTY_ATSTART | PCRE2_ANCHORED);
-  int rc = pcre2_match( re, cstr, len, start, options, match_data, match_ctx );
+  int rc = kk_regex_match( re, cstr, len, start, options, match_data );
   if (res != NULL) *res = rc;    
   if (rc > 0) {    
     // extract captures
@@ -136,21 +311,20 @@ static kk_std_core__list kk_regex_exec( kk_box_t bre, kk_string_t str, kk_ssize_
   // unpack
   pcre2_match_data* match_data = NULL;
   kk_std_core__list res = kk_std_core__new_Nil(ctx);
-  pcre2_code* re = (pcre2_code*)kk_cptr_raw_unbox(bre);
+  kk_regex_t* re = (kk_regex_t*)kk_cptr_raw_unbox(bre);
   kk_ssize_t len = 0;
   const uint8_t* cstr = NULL;
   if (re == NULL) goto done;    
-  match_data = pcre2_match_data_create_from_pattern(re, gen_ctx);
+  match_data = kk_regex_match_data_acquire(re,ctx);
   if (match_data==NULL) goto done;  
   cstr = kk_string_buf_borrow(str, &len );  
 
   // and match
-  res = kk_regex_exec_ex( re, match_data, str, cstr, len, true, start, NULL, NULL, NULL, ctx );
+  res = kk_regex_exec_ex( re->code, match_data, str, cstr, len, true, start, NULL, NULL, NULL, ctx );
 
 done:  
-  if (match_data != NULL) {
-    //kk_info_message( "free match data: %p\n", match_data );
-    pcre2_match_data_free(match_data);
+  if (re != NULL) {
+    kk_regex_match_data_release(re, match_data, ctx);
   }
   kk_string_drop(str,ctx);
   kk_box_drop(bre,ctx);
@@ -162,9 +336,9 @@ static kk_std_core__list kk_regex_exec_all( kk_box_t bre, kk_string_t str, kk_ss
   if (atmost < 0) atmost = KK_SSIZE_MAX;
   pcre2_match_data* match_data = NULL;
   kk_std_core__list res = kk_std_core__new_Nil(ctx);
-  pcre2_code* re = (pcre2_code*)kk_cptr_raw_unbox(bre);
+  kk_regex_t* re = (kk_regex_t*)kk_cptr_raw_unbox(bre);
   if (re == NULL) goto done;    
-  match_data = pcre2_match_data_create_from_pattern(re, gen_ctx);
+  match_data = kk_regex_match_data_acquire(re,ctx);
   if (match_data==NULL) goto done;  
   {
     kk_ssize_t len;
@@ -179,7 +353,7 @@ static kk_std_core__list kk_regex_exec_all( kk_box_t bre, kk_string_t str, kk_ss
       atmost--;
       rc = 0;
       kk_ssize_t mstart = start;
-      kk_std_core__list cap = kk_regex_exec_ex( re, match_data, str, cstr, len, allow_empty, start, &mstart, &next, &rc, ctx );
+      kk_std_core__list cap = kk_regex_exec_ex( re->code, match_data, str, cstr, len, allow_empty, start, &mstart, &next, &rc, ctx );
       if (rc > 0) {
         // found a match; 
         // push string up to match, and the actual matched regex
@@ -212,19 +386,500 @@ static kk_std_core__list kk_regex_exec_all( kk_box_t bre, kk_string_t str, kk_ss
   }
 
 done:  
-  if (match_data != NULL) {
-    //kk_info_message( "free match data: %p\n", match_data );
-    pcre2_match_data_free(match_data);
+  if (re != NULL) {
+    kk_regex_match_data_release(re, match_data, ctx);
   }
   kk_string_drop(str,ctx);
   kk_box_drop(bre,ctx);
   return res;
 }
 
-/*
-kk_std_core__sslice kk_slice_upto( struct kk_std_core_Sslice slice1, struct kk_std_core_Sslice slice2, kk_context_t* ctx ) {
-  kk_ssize_t start = slice1.start;
-  kk_ssize_t len   = (slice1.start <= slice2.start ? slice2.start - slice1.start : -1);
-  return kk_std_core__new_Sslice(slice1.str, start, len, ctx);
+
+/* -----------------------------------------------------------------------
+  Matcher: iterate over the matches in a string without allocating
+  a list of slices for each match. The match data is owned by the
+  matcher for the duration of the iteration.
+------------------------------------------------------------------------*/
+
+typedef struct kk_regex_matcher_s {
+  kk_box_t          bre;
+  kk_regex_t*       re;
+  pcre2_match_data* match_data;
+  kk_string_t       str;
+  const uint8_t*    cstr;
+  kk_ssize_t        len;
+  kk_ssize_t        start;
+  kk_ssize_t        atmost;
+  bool              allow_empty;
+} kk_regex_matcher_t;
+
+static bool kk_regex_matcher_init( kk_regex_matcher_t* m, kk_box_t bre, kk_string_t str, kk_ssize_t start, kk_ssize_t atmost, kk_context_t* ctx ) {
+  m->bre = bre;
+  m->re  = (kk_regex_t*)kk_cptr_raw_unbox(bre);
+  m->match_data = (m->re == NULL ? NULL : kk_regex_match_data_acquire(m->re,ctx));
+  m->str = str;
+  m->cstr = kk_string_buf_borrow(str, &m->len);
+  m->start = start;
+  m->atmost = (atmost < 0 ? KK_SSIZE_MAX : atmost);
+  m->allow_empty = true;
+  return (m->match_data != NULL);
+}
+
+static void kk_regex_matcher_done( kk_regex_matcher_t* m, kk_context_t* ctx ) {
+  if (m->re != NULL) {
+    kk_regex_match_data_release(m->re, m->match_data, ctx);
+    m->match_data = NULL;
+  }
+  kk_string_drop(m->str,ctx);
+  kk_box_drop(m->bre,ctx);
+}
+
+// Find the next match; on success the ovector of the match data contains the group offsets.
+// Follows the same rules as `kk_regex_exec_all` for empty matches.
+static bool kk_regex_matcher_step( kk_regex_matcher_t* m ) {
+  if (m->match_data == NULL) return false;
+  while (m->start < m->len && m->atmost > 0) {
+    uint32_t options = 0;
+    if (!m->allow_empty) options |= (PCRE2_NOTEMPTY_ATSTART | PCRE2_ANCHORED);
+    int rc = kk_regex_match( m->re->code, m->cstr, m->len, m->start, options, m->match_data );
+    if (rc > 0) {
+      PCRE2_SIZE* groups = pcre2_get_ovector_pointer(m->match_data);
+      kk_ssize_t next = (kk_ssize_t)groups[1];
+      m->atmost--;
+      m->allow_empty = (next > m->start);
+      m->start = next;
+      return true;
+    }
+    else if (!m->allow_empty) {
+      // skip one character and try again
+      const uint8_t* p = kk_utf8_next( m->cstr + m->start );
+      m->start = (p - m->cstr);
+      m->allow_empty = true;
+    }
+    else {
+      break;
+    }
+  }
+  m->atmost = 0;
+  return false;
+}
+
+static void kk_regex_matcher_free( void* p, kk_block_t* b, kk_context_t* ctx ) {
+  kk_unused(b);
+  kk_regex_matcher_t* m = (kk_regex_matcher_t*)p;
+  kk_regex_matcher_done(m,ctx);
+  kk_free(m,ctx);
+}
+
+static kk_box_t kk_regex_matcher_create( kk_box_t bre, kk_string_t str, kk_ssize_t start, kk_ssize_t atmost, kk_context_t* ctx ) {
+  kk_regex_matcher_t* m = (kk_regex_matcher_t*)kk_malloc( kk_ssizeof(kk_regex_matcher_t), ctx );
+  kk_regex_matcher_init(m, bre, str, start, atmost, ctx);
+  return kk_cptr_raw_box( &kk_regex_matcher_free, m, ctx );
+}
+
+static bool kk_regex_matcher_next( kk_box_t bm, kk_context_t* ctx ) {
+  kk_regex_matcher_t* m = (kk_regex_matcher_t*)kk_cptr_raw_unbox(bm);
+  bool found = kk_regex_matcher_step(m);
+  kk_box_drop(bm,ctx);
+  return found;
+}
+
+// The offset of a capture group in the current match (or -1 if the group was not matched).
+static kk_ssize_t kk_regex_matcher_offset( kk_regex_matcher_t* m, kk_ssize_t group, bool end ) {
+  if (m->match_data == NULL || group < 0 || group >= (kk_ssize_t)pcre2_get_ovector_count(m->match_data)) return -1;
+  PCRE2_SIZE* groups = pcre2_get_ovector_pointer(m->match_data);
+  PCRE2_SIZE  gofs   = groups[2*group + (end ? 1 : 0)];
+  return (gofs == PCRE2_UNSET ? -1 : (kk_ssize_t)gofs);
+}
+
+static kk_ssize_t kk_regex_matcher_group_offset( kk_box_t bm, kk_ssize_t group, bool end, kk_context_t* ctx ) {
+  kk_ssize_t ofs = kk_regex_matcher_offset( (kk_regex_matcher_t*)kk_cptr_raw_unbox(bm), group, end );
+  kk_box_drop(bm,ctx);
+  return ofs;
+}
+
+static kk_ssize_t kk_regex_matcher_group_start( kk_box_t bm, kk_ssize_t group, kk_context_t* ctx ) {
+  return kk_regex_matcher_group_offset(bm, group, false, ctx);
+}
+
+static kk_ssize_t kk_regex_matcher_group_end( kk_box_t bm, kk_ssize_t group, kk_context_t* ctx ) {
+  return kk_regex_matcher_group_offset(bm, group, true, ctx);
+}
+
+static kk_std_core__sslice kk_regex_matcher_group( kk_box_t bm, kk_ssize_t group, kk_context_t* ctx ) {
+  kk_regex_matcher_t* m = (kk_regex_matcher_t*)kk_cptr_raw_unbox(bm);
+  kk_ssize_t sstart = kk_regex_matcher_offset(m, group, false);
+  kk_std_core__sslice slice;
+  if (sstart < 0) {
+    slice = kk_std_core__new_Sslice( kk_string_empty(), -1, 0, ctx );
+  }
+  else {
+    kk_ssize_t send = kk_regex_matcher_offset(m, group, true);
+    slice = kk_std_core__new_Sslice( kk_string_dup(m->str), sstart, send - sstart, ctx );
+  }
+  kk_box_drop(bm,ctx);
+  return slice;
+}
+
+static kk_ssize_t kk_regex_matcher_group_count( kk_box_t bm, kk_context_t* ctx ) {
+  kk_regex_matcher_t* m = (kk_regex_matcher_t*)kk_cptr_raw_unbox(bm);
+  kk_ssize_t count = (m->match_data == NULL ? 0 : (kk_ssize_t)pcre2_get_ovector_count(m->match_data));
+  kk_box_drop(bm,ctx);
+  return count;
+}
+
+
+/* -----------------------------------------------------------------------
+  Fast paths that never build slices
+------------------------------------------------------------------------*/
+
+static bool kk_regex_contains( kk_box_t bre, kk_string_t str, kk_ssize_t start, kk_context_t* ctx ) {
+  kk_regex_matcher_t m;
+  kk_regex_matcher_init(&m, bre, str, start, 1, ctx);
+  // unlike `kk_regex_matcher_step` we also allow an empty match at the end
+  bool found = (m.match_data != NULL && start <= m.len &&
+                kk_regex_match( m.re->code, m.cstr, m.len, start, 0, m.match_data ) > 0);
+  kk_regex_matcher_done(&m,ctx);
+  return found;
+}
+
+static kk_ssize_t kk_regex_count( kk_box_t bre, kk_string_t str, kk_ssize_t start, kk_ssize_t atmost, kk_context_t* ctx ) {
+  kk_regex_matcher_t m;
+  kk_regex_matcher_init(&m, bre, str, start, atmost, ctx);
+  kk_ssize_t count = 0;
+  while (kk_regex_matcher_step(&m)) {
+    count++;
+  }
+  kk_regex_matcher_done(&m,ctx);
+  return count;
+}
+
+/* -----------------------------------------------------------------------
+  Regex sets: match many patterns in a single pass.
+
+  Each pattern is first compiled on its own to validate it. Patterns that
+  can be combined are then joined in one branch-reset alternation (so back
+  references keep their numbering) where every alternative is surrounded
+  by string callouts:
+    `(?|(?C{+0})(?:p0\E)(?C{0})(*THEN)(*F)|(?C{+1})(?:p1\E)(?C{1})(*THEN)(*F)|...)`
+  The callout after a pattern records it as matched, after which `(*THEN)(*F)`
+  moves on to the next alternative without backtracking into the pattern
+  (so we never enumerate all the ways a pattern can match). The callout before
+  a pattern skips alternatives that already matched, and the match is aborted
+  once all patterns have matched. Note that the combined pattern is still
+  tried at every position for each pattern that did not match yet, and it
+  loses the first character and literal optimizations of the separate patterns.
+
+  The `\E` ends an unterminated `\Q` quote in a pattern (and is ignored
+  otherwise). Patterns that could still interfere with the combined
+  pattern are matched on their own instead (see `kk_regex_set_combinable`),
+  and we verify that the combined pattern has exactly the expected callouts.
+------------------------------------------------------------------------*/
+
+typedef struct kk_regex_set_scratch_s {
+  pcre2_match_data*    match_data;
+  pcre2_match_context* match_ctx;
+  kk_ssize_t           remaining;   // combined patterns that did not match yet
+  bool                 matched[1];  // `count` entries
+} kk_regex_set_scratch_t;
+
+typedef struct kk_regex_set_s {
+  kk_ssize_t      count;
+  pcre2_code**    codes;            // `count` patterns compiled on their own (NULL if part of `combined`)
+  pcre2_code*     combined;         // the combined patterns (or NULL)
+  kk_ssize_t      combined_count;
+  char*           error;            // description of the first invalid pattern (or NULL)
+  kk_regex_pool_t scratch;
+} kk_regex_set_t;
+
+static void kk_regex_set_scratch_free( kk_regex_set_scratch_t* scratch, kk_context_t* ctx ) {
+  if (scratch == NULL) return;
+  if (scratch->match_data != NULL) pcre2_match_data_free(scratch->match_data);
+  if (scratch->match_ctx != NULL) pcre2_match_context_free(scratch->match_ctx);
+  kk_free(scratch,ctx);
+}
+
+static void kk_regex_set_free( void* p, kk_block_t* b, kk_context_t* ctx ) {
+  kk_unused(b);
+  kk_regex_set_t* rs = (kk_regex_set_t*)p;
+  if (rs == NULL) return;
+  kk_regex_set_scratch_t* scratch;
+  while ((scratch = (kk_regex_set_scratch_t*)kk_regex_pool_take(&rs->scratch, ctx)) != NULL) {
+    kk_regex_set_scratch_free(scratch,ctx);
+  }
+  for (kk_ssize_t i = 0; i < rs->count; i++) {
+    if (rs->codes[i] != NULL) pcre2_code_free(rs->codes[i]);
+  }
+  if (rs->combined != NULL) pcre2_code_free(rs->combined);
+  if (rs->error != NULL) kk_free(rs->error,ctx);
+  kk_free(rs->codes,ctx);
+  kk_free(rs,ctx);
+}
+
+static int kk_regex_set_callout( pcre2_callout_block* block, void* data ) {
+  kk_regex_set_scratch_t* scratch = (kk_regex_set_scratch_t*)data;
+  const char* s = (const char*)block->callout_string;
+  if (s == NULL) return 0;
+  const bool before = (*s == '+');
+  if (before) s++;
+  const kk_ssize_t i = (kk_ssize_t)strtol(s, NULL, 10);
+  if (before) {
+    return (scratch->matched[i] ? 1 : 0);  // skip patterns that already matched
+  }
+  if (!scratch->matched[i]) {
+    scratch->matched[i] = true;
+    scratch->remaining--;
+  }
+  // continue with `(*THEN)(*F)` to try the next pattern
+  return (scratch->remaining <= 0 ? PCRE2_ERROR_CALLOUT : 0);
+}
+
+// Can a (valid) pattern be matched as an alternative of the combined pattern?
+// We conservatively exclude patterns with named groups (whose names can clash with
+// other alternatives), subroutine calls (which refer to the groups of the first
+// alternative in a branch-reset group), callouts, backtracking verbs (which interfere
+// with the callouts), and possible comments in extended mode (which could swallow
+// the closing of the group).
+static bool kk_regex_set_combinable( const uint8_t* src, kk_ssize_t len, pcre2_code* code ) {
+  uint32_t names = 0;
+  if (pcre2_pattern_info(code, PCRE2_INFO_NAMECOUNT, &names) != 0 || names > 0) return false;
+  bool has_group = false;
+  bool has_hash  = false;
+  for (kk_ssize_t i = 0; i < len; i++) {
+    const uint8_t c = src[i];
+    if (c == '\\' && i + 1 < len) {
+      if (src[i+1] == 'g' && i + 2 < len && (src[i+2] == '<' || src[i+2] == '\'')) return false;  // \g<name>
+      i++;
+    }
+    else if (c == '#') {
+      has_hash = true;
+    }
+    else if (c == '(' && i + 1 < len) {
+      const uint8_t d = src[i+1];
+      if (d == '*') return false;   // verbs
+      if (d == '?' && i + 2 < len) {
+        const uint8_t e = src[i+2];
+        if (e == 'R' || e == '&' || e == 'C' || e == '+' || e == '-' || (e >= '0' && e <= '9')) return false;
+        if (e == 'P' && i + 3 < len && src[i+3] == '>') return false;
+        has_group = true;
+      }
+    }
+  }
+  return !(has_hash && has_group);
+}
+
+// Check that the combined pattern contains exactly the callouts we inserted.
+typedef struct kk_regex_set_verify_s {
+  const kk_ssize_t* indices;
+  kk_ssize_t        count;
+  kk_ssize_t        next;    // index of the next expected callout (two per pattern)
+} kk_regex_set_verify_t;
+
+static int kk_regex_set_verify_callout( pcre2_callout_enumerate_block* block, void* data ) {
+  kk_regex_set_verify_t* v = (kk_regex_set_verify_t*)data;
+  const char* s = (const char*)block->callout_string;
+  if (s == NULL || v->next >= 2*v->count) return 1;
+  char expect[32];
+  snprintf(expect, sizeof(expect), "%s%lld", (v->next % 2 == 0 ? "+" : ""), (long long)v->indices[v->next/2]);
+  if (strcmp(s, expect) != 0) return 1;
+  v->next++;
+  return 0;
+}
+
+static bool kk_regex_set_verify( pcre2_code* code, const kk_ssize_t* indices, kk_ssize_t count ) {
+  kk_regex_set_verify_t v = { indices, count, 0 };
+  return (pcre2_callout_enumerate(code, &kk_regex_set_verify_callout, &v) == 0 && v.next == 2*count);
+}
+
+static char* kk_regex_set_error_message( kk_ssize_t i, int errnum, PCRE2_SIZE errofs, kk_context_t* ctx ) {
+  uint8_t msg[256];
+  if (pcre2_get_error_message(errnum, msg, sizeof(msg)) < 0) { msg[0] = 0; }
+  const size_t size = 300;
+  char* err = (char*)kk_malloc( (kk_ssize_t)size, ctx );
+  snprintf(err, size, "pattern %lld: %s (at offset %llu)", (long long)i, (const char*)msg, (unsigned long long)errofs);
+  return err;
+}
+
+// Combine the patterns at `indices` into one pattern (or return NULL if that is not possible).
+static pcre2_code* kk_regex_set_combine( kk_box_t* elems, const kk_ssize_t* indices, kk_ssize_t count, uint32_t options, kk_context_t* ctx ) {
+  const kk_ssize_t extra = 80;  // room for the callouts and grouping of each pattern
+  kk_ssize_t size = 8;
+  for (kk_ssize_t j = 0; j < count; j++) {
+    kk_ssize_t len;
+    kk_string_buf_borrow( kk_string_unbox(elems[indices[j]]), &len );
+    size += len + extra;
+  }
+  char* cpat = (char*)kk_malloc(size, ctx);
+  char* q = cpat;
+  q += snprintf(q, kk_to_size_t(size - (q - cpat)), "(?|");
+  for (kk_ssize_t j = 0; j < count; j++) {
+    const kk_ssize_t i = indices[j];
+    kk_ssize_t len;
+    const uint8_t* src = kk_string_buf_borrow( kk_string_unbox(elems[i]), &len );
+    q += snprintf(q, kk_to_size_t(size - (q - cpat)), "%s(?C{+%lld})(?:", (j > 0 ? "|" : ""), (long long)i);
+    memcpy(q, src, kk_to_size_t(len)); q += len;
+    q += snprintf(q, kk_to_size_t(size - (q - cpat)), "\\E)(?C{%lld})(*THEN)(*F)", (long long)i);
+  }
+  q += snprintf(q, kk_to_size_t(size - (q - cpat)), ")");
+  PCRE2_SIZE errofs = 0;
+  int        errnum = 0;
+  pcre2_code* code = pcre2_compile( (const uint8_t*)cpat, (PCRE2_SIZE)(q - cpat), options, &errnum, &errofs, cmp_ctx);
+  kk_free(cpat,ctx);
+  if (code != NULL && !kk_regex_set_verify(code, indices, count)) {
+    pcre2_code_free(code);
+    code = NULL;
+  }
+  return code;
+}
+
+static kk_box_t kk_regex_set_create( kk_vector_t pats, bool ignore_case, bool multi_line, kk_context_t* ctx ) {
+  kk_ssize_t count;
+  kk_box_t* elems = kk_vector_buf_borrow(pats, &count);
+  uint32_t options = KK_REGEX_OPTIONS;
+  if (ignore_case) options |= PCRE2_CASELESS;
+  if (multi_line)  options |= PCRE2_MULTILINE;
+  kk_regex_set_t* rs = (kk_regex_set_t*)kk_zalloc( kk_ssizeof(kk_regex_set_t), ctx );
+  rs->count = count;
+  rs->codes = (pcre2_code**)kk_zalloc( (count + 1) * kk_ssizeof(pcre2_code*), ctx );
+  // compile each pattern on its own, and determine which ones can be combined
+  kk_ssize_t* indices = (kk_ssize_t*)kk_malloc( (count + 1) * kk_ssizeof(kk_ssize_t), ctx );
+  kk_ssize_t  combine_count = 0;
+  for (kk_ssize_t i = 0; i < count && rs->error == NULL; i++) {
+    kk_ssize_t len;
+    const uint8_t* src = kk_string_buf_borrow( kk_string_unbox(elems[i]), &len );
+    PCRE2_SIZE errofs = 0;
+    int        errnum = 0;
+    rs->codes[i] = pcre2_compile( src, (PCRE2_SIZE)len, options, &errnum, &errofs, cmp_ctx );
+    if (rs->codes[i] == NULL) {
+      rs->error = kk_regex_set_error_message(i, errnum, errofs, ctx);
+    }
+    else if (kk_regex_set_combinable(src, len, rs->codes[i])) {
+      indices[combine_count++] = i;
+    }
+  }
+  if (rs->error == NULL && combine_count > 1) {
+    rs->combined = kk_regex_set_combine(elems, indices, combine_count, options, ctx);
+    if (rs->combined != NULL) {
+      pcre2_jit_compile( rs->combined, PCRE2_JIT_COMPLETE );
+      rs->combined_count = combine_count;
+      for (kk_ssize_t j = 0; j < combine_count; j++) {
+        pcre2_code_free(rs->codes[indices[j]]);
+        rs->codes[indices[j]] = NULL;
+      }
+    }
+  }
+  if (rs->error == NULL) {
+    for (kk_ssize_t i = 0; i < count; i++) {
+      if (rs->codes[i] != NULL) pcre2_jit_compile( rs->codes[i], PCRE2_JIT_COMPLETE );
+    }
+  }
+  kk_free(indices,ctx);
+  kk_vector_drop(pats,ctx);
+  return kk_cptr_raw_box( &kk_regex_set_free, rs, ctx );
+}
+
+// The description of the first invalid pattern in a set (or the empty string if all are valid).
+static kk_string_t kk_regex_set_error( kk_box_t brs, kk_context_t* ctx ) {
+  kk_regex_set_t* rs = (kk_regex_set_t*)kk_cptr_raw_unbox(brs);
+  kk_string_t err = (rs == NULL || rs->error == NULL ? kk_string_empty() : kk_string_alloc_from_qutf8(rs->error, ctx));
+  kk_box_drop(brs,ctx);
+  return err;
+}
+
+static kk_regex_set_scratch_t* kk_regex_set_scratch_acquire( kk_regex_set_t* rs, kk_context_t* ctx ) {
+  kk_regex_set_scratch_t* scratch = (kk_regex_set_scratch_t*)kk_regex_pool_take(&rs->scratch, ctx);
+  if (scratch == NULL) {
+    scratch = (kk_regex_set_scratch_t*)kk_zalloc( kk_ssizeof(kk_regex_set_scratch_t) + rs->count, ctx );
+    scratch->match_data = pcre2_match_data_create( 1, gen_ctx );   // we only need the match result
+    scratch->match_ctx  = (match_ctx == NULL ? NULL : pcre2_match_context_copy(match_ctx));
+    if (scratch->match_data == NULL || scratch->match_ctx == NULL) {
+      kk_regex_set_scratch_free(scratch,ctx);
+      return NULL;
+    }
+    pcre2_set_callout( scratch->match_ctx, &kk_regex_set_callout, scratch );
+  }
+  else {
+    memset(scratch->matched, 0, kk_to_size_t(rs->count));
+  }
+  scratch->remaining = rs->combined_count;
+  return scratch;
+}
+
+static void kk_regex_set_scratch_release( kk_regex_set_t* rs, kk_regex_set_scratch_t* scratch, kk_context_t* ctx ) {
+  if (scratch == NULL) return;
+  if (!kk_regex_pool_put(&rs->scratch, scratch, ctx)) {
+    kk_regex_set_scratch_free(scratch,ctx);
+  }
+}
+
+static kk_string_t kk_regex_set_match_error( int rc, kk_ssize_t i, kk_context_t* ctx ) {
+  uint8_t msg[256];
+  if (pcre2_get_error_message(rc, msg, sizeof(msg)) < 0) { msg[0] = 0; }
+  char err[300];
+  if (i < 0) {
+    snprintf(err, sizeof(err), "matching failed: %s", (const char*)msg);
+  }
+  else {
+    snprintf(err, sizeof(err), "matching pattern %lld failed: %s", (long long)i, (const char*)msg);
+  }
+  return kk_string_alloc_from_qutf8(err, ctx);
+}
+
+// Return the (ascending) indices of all patterns that match somewhere in `str` (from `start`),
+// or an error message if matching fails (for example, when the match or depth limit is exceeded).
+static kk_std_core_types__either kk_regex_set_matches( kk_box_t brs, kk_string_t str, kk_ssize_t start, kk_context_t* ctx ) {
+  kk_std_core__list res = kk_std_core__new_Nil(ctx);
+  kk_regex_set_t* rs = (kk_regex_set_t*)kk_cptr_raw_unbox(brs);
+  kk_regex_set_scratch_t* scratch = (rs == NULL || rs->error != NULL ? NULL : kk_regex_set_scratch_acquire(rs,ctx));
+  int rc = 0;
+  kk_ssize_t failed = -1;  // the pattern that failed to match (or -1 for the combined pattern)
+  if (rs != NULL && rs->error != NULL) {
+    kk_string_drop(str,ctx);
+    kk_string_t err = kk_string_alloc_from_qutf8(rs->error, ctx);
+    kk_box_drop(brs,ctx);
+    return kk_std_core_types__new_Left( kk_string_box(err), ctx );
+  }
+  else if (scratch == NULL) {
+    rc = PCRE2_ERROR_NOMEMORY;
+  }
+  else {
+    kk_ssize_t len;
+    const uint8_t* cstr = kk_string_buf_borrow(str, &len);
+    if (rs->combined != NULL) {
+      rc = pcre2_match( rs->combined, cstr, (PCRE2_SIZE)len, (PCRE2_SIZE)start, 0, scratch->match_data, scratch->match_ctx );
+      if (rc == PCRE2_ERROR_JIT_STACKLIMIT) {
+        memset(scratch->matched, 0, kk_to_size_t(rs->count));
+        scratch->remaining = rs->combined_count;
+        rc = pcre2_match( rs->combined, cstr, (PCRE2_SIZE)len, (PCRE2_SIZE)start, PCRE2_NO_JIT, scratch->match_data, scratch->match_ctx );
+      }
+      // every alternative ends in `(*F)`: the match either fails, or is aborted by
+      // our callout once all patterns matched; anything else is an error (like the match limit)
+      rc = (rc == PCRE2_ERROR_NOMATCH || rc == PCRE2_ERROR_CALLOUT ? 0 : (rc >= 0 ? PCRE2_ERROR_INTERNAL : rc));
+    }
+    // and the patterns that are matched on their own
+    for (kk_ssize_t i = 0; i < rs->count && rc == 0; i++) {
+      if (rs->codes[i] != NULL) {
+        // a result of 0 means the match data is too small for all groups, but there is a match
+        const int irc = kk_regex_match( rs->codes[i], cstr, len, start, 0, scratch->match_data );
+        scratch->matched[i] = (irc >= 0);
+        if (irc < 0 && irc != PCRE2_ERROR_NOMATCH) {
+          rc = irc;
+          failed = i;
+        }
+      }
+    }
+    for (kk_ssize_t i = rs->count; i > 0 && rc == 0; ) {
+      i--;
+      if (scratch->matched[i]) {
+        res = kk_std_core__new_Cons(kk_reuse_null, kk_integer_box(kk_integer_from_ssize_t(i,ctx)), res, ctx);
+      }
+    }
+    kk_regex_set_scratch_release(rs, scratch, ctx);
+  }
+  kk_string_drop(str,ctx);
+  kk_box_drop(brs,ctx);
+  if (rc != 0) {
+    return kk_std_core_types__new_Left( kk_string_box(kk_regex_set_match_error(rc, failed, ctx)), ctx );
+  }
+  return kk_std_core_types__new_Right( kk_std_core__list_box(res,ctx), ctx );
 }
-*/
\ No newline at end of file
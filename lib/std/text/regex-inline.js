@@ -110,6 +110,113 @@ function $regexExecAll( r,  s, start, atmost )
   return $std_core._vlist(result,null);
 }
 
+function $regexContains( r, s, start )
+{
+  r.regex.lastIndex = start;
+  return r.regex.test(s);
+}
+
+function $regexCount( r, s, start, atmost )
+{
+  const m = $regexMatcherCreate(r,s,start,atmost);
+  var count = 0;
+  while ($regexMatcherNext(m)) { count++; }
+  return count;
+}
+
+// Matcher: iterate over matches without creating slices
+function $regexMatcherCreate( r, s, start, atmost )
+{
+  if (atmost < 0) { atmost = Number.MAX_SAFE_INTEGER; }
+  return { rx: r, str: s, start: start, atmost: atmost, match: null };
+}
+
+function $regexMatcherNext( m )
+{
+  m.match = null;
+  if (m.atmost <= 0) return false;
+  m.rx.regex.lastIndex = m.start;
+  const match = m.rx.regex.exec(m.str);
+  if (!match) {
+    m.atmost = 0;
+    return false;
+  }
+  m.match = match;
+  m.atmost--;
+  // avoid loop on zero-length match (as in `$regexExecAll`)
+  const next = m.rx.regex.lastIndex;
+  m.start = (next <= m.start ? m.start + 1 : next);
+  return true;
+}
+
+function $regexMatcherGroupOffset( m, group, end )
+{
+  const match = m.match;
+  if (match == null || group < 0 || group >= match.length) return -1;
+  if (match.indices instanceof Array) {
+    const rng = match.indices[group];
+    return (rng == null ? -1 : rng[end ? 1 : 0]);
+  }
+  else if (group === 0) {
+    // older JS, no 'd' flag for indices
+    return (end ? match.index + match[0].length : match.index);
+  }
+  else {
+    return -1;
+  }
+}
+
+function $regexMatcherGroupStart( m, group )
+{
+  return $regexMatcherGroupOffset(m,group,false);
+}
+
+function $regexMatcherGroupEnd( m, group )
+{
+  return $regexMatcherGroupOffset(m,group,true);
+}
+
+function $regexMatcherGroupCount( m )
+{
+  return (m.match == null ? 0 : m.match.length);
+}
+
+function $regexMatcherGroup( m, group )
+{
+  const start = $regexMatcherGroupOffset(m,group,false);
+  if (start < 0) return $std_core.invalid;
+  return $std_core._new_sslice(m.str, start, $regexMatcherGroupOffset(m,group,true) - start);
+}
+
+// Regex sets: we just match each regex in turn
+function $regexSetCreate( sources, ignoreCase, multiLine )
+{
+  var regexs = [];
+  for( var i = 0; i < sources.length; i++) {
+    try {
+      regexs.push($regexCreate(sources[i],ignoreCase,multiLine));
+    }
+    catch(exn) {
+      return { regexs: [], error: "pattern " + i.toString() + ": " + (exn.message != null ? exn.message : exn.toString()) };
+    }
+  }
+  return { regexs: regexs, error: "" };
+}
+
+function $regexSetError( rs )
+{
+  return rs.error;
+}
+
+function $regexSetMatches( rs, s, start )
+{
+  var result = [];
+  for( var i = 0; i < rs.regexs.length; i++) {
+    if ($regexContains(rs.regexs[i],s,start)) result.push(i);
+  }
+  return $std_core_types.Right($std_core._vlist(result,null));
+}
+
 
 /*
 
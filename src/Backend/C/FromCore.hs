@@ -324,7 +324,7 @@ genFunSig inlineC vis name defExpr
 genLamSig :: Bool -> Visibility -> Name -> [TName] -> Expr -> Doc
 genLamSig inlineC vis name params body
   = (if (inlineC) then text "static inline "
-       -- else if (not (isPublic vis)) then text "static "
+       else if (not (isPublic vis)) then text "kk_decl_private "  -- only static in a unity build as inlined definitions can refer to it
        else empty) <.>
     ppType (typeOf body) <+> ppName name <.> tparameters params
 
@@ -1343,6 +1343,8 @@ genExprStat result expr
 
 -- | Generates a statement for a match expression regarding a given return context
 genMatch :: Result -> [Doc] -> [Branch] -> Asm Doc
+genMatch result0 exprDocs branches  | Just (tagDoc,caseTags) <- genSwitchTags exprDocs branches
+  = genMatchSwitch result0 exprDocs tagDoc caseTags branches
 genMatch result0 exprDocs branches
   = do -- mbTagDocs <- mapM genTag (zip exprDocs (transpose (map branchPatterns branches)))
        (result,genLabel)
@@ -1393,6 +1395,67 @@ genMatch result0 exprDocs branches
           PatCon{patConPatterns = ps, patConSkip = skip} -> skip && all isZeroTestPat ps
           _          -> False
 
+-- | A match on a single heap allocated datatype with many constructor alternatives is
+-- generated as a `switch` on the constructor tag instead of a chain of `is_Con` tests.
+-- The tag is loaded only once and the C compiler can use a jump table.
+-- This is only done if each branch (but the last) is decided by its top-level constructor
+-- alone (no nested tests or guards) so no branch can fall through to the next one.
+-- The last branch is always taken if none of the others match and becomes the `default`.
+genMatchSwitch :: Result -> [Doc] -> Doc -> [Doc] -> [Branch] -> Asm Doc
+genMatchSwitch result exprDocs tagDoc caseTags branches
+  = do docsInit <- mapM (genBranch result exprDocs False) (init branches)
+       docLast  <- genBranch result exprDocs False (last branches)
+       let cases = [text "case" <+> tag <.> colon <+> doc <-> text "break;" | (tag,doc) <- zip caseTags docsInit]
+       return (text "switch" <+> parens tagDoc <+> block (vcat (cases ++ [text "default:" <+> docLast])))
+
+-- | Minimal number of constructor alternatives before we generate a `switch`
+switchMinAlternatives :: Int
+switchMinAlternatives = 4
+
+-- | Returns the tag load and the case tags if a match can be generated as a `switch`.
+genSwitchTags :: [Doc] -> [Branch] -> Maybe (Doc,[Doc])
+genSwitchTags [exprDoc] branches  | length branches > switchMinAlternatives
+  = do cons <- mapM switchCon (init branches)
+       let dataRepr = conDataRepr (snd (head cons))
+           tags     = map (conTag . snd) cons
+       if (isSwitchDataRepr dataRepr && all ((==dataRepr) . conDataRepr . snd) cons && distinct tags)
+         then let tagLoad = text (if (dataReprMayHaveSingletons dataRepr) then "kk_datatype_tag" else "kk_basetype_tag")
+                            <.> parens exprDoc
+              in Just (tagLoad, [ppConTag con conRepr dataRepr | (con,conRepr) <- cons])
+         else Nothing
+  where
+    switchCon (Branch [pat] [Guard test _])  | isExprTrue test
+      = topCon pat
+    switchCon _
+      = Nothing
+
+    topCon pat
+      = case pat of
+          PatVar _ p -> topCon p
+          PatCon{patConName=cname, patConRepr=repr, patConInfo=info, patConPatterns=ps}
+            | getName cname /= nameBoxCon && (isConNormal repr || isConSingleton repr) && all isNoTestPat ps
+            -> Just (info,repr)
+          _ -> Nothing
+
+    isNoTestPat pat
+      = case pat of
+          PatWild    -> True
+          PatVar _ p -> isNoTestPat p
+          PatCon{patConName=cname, patConPatterns=ps, patConSkip=skip}
+                     -> (skip || getName cname == nameBoxCon) && all isNoTestPat ps
+          _          -> False
+
+    isSwitchDataRepr dataRepr
+      = case dataRepr of
+          DataNormal{}     -> True
+          DataSingleNormal -> True
+          _                -> False
+
+    distinct xs
+      = S.size (S.fromList xs) == length xs
+genSwitchTags _ _
+  = Nothing
+
 genBranch :: Result -> [Doc] -> Bool -> Branch -> Asm Doc
 genBranch result exprDocs doTest branch@(Branch patterns guards)
   = do doc <- genPattern doTest (freeLocals guards)  (zip exprDocs patterns) (genGuards result guards)
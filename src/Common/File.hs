@@ -40,11 +40,18 @@ module Common.File(
                   , copyTextFile, copyTextIfNewer, copyTextIfNewerWith, copyTextFileWith
                   , copyBinaryFile, copyBinaryIfNewer
                   , removeFileIfExists
+                  , FileHash, hashString, getFileHash
+                  , sameFileContent, moveFileIfChanged
                   , realPath
                   , doesFileExistAndNotEmpty
+                  , getFilesRecursive
                   ) where
 
-import Data.List        ( intersperse )
+import Data.List        ( intersperse, foldl', sort )
+import Data.Bits        ( xor )
+import Data.Word        ( Word64 )
+import Numeric          ( showHex )
+import qualified Data.ByteString as BS
 import Data.Char        ( toLower, isSpace )
 import Platform.Config  ( pathSep, pathDelimiter, sourceExtension, exeExtension )
 import qualified Platform.Runtime as B ( {- copyBinaryFile, -} exCatch )
@@ -57,7 +64,7 @@ import System.Environment ( getEnvironment, getExecutablePath )
 import System.Directory ( doesFileExist, doesDirectoryExist
                         {- , copyFile, copyFileWithMetadata -}
                         , getCurrentDirectory, getDirectoryContents
-                        , createDirectoryIfMissing, canonicalizePath, removeFile )
+                        , createDirectoryIfMissing, canonicalizePath, removeFile, renameFile )
 
 import Lib.Trace
 import Platform.Filetime
@@ -292,6 +299,19 @@ maxFileTimes :: [FileTime] -> FileTime
 maxFileTimes times
   = foldr maxFileTime fileTime0 times
 
+-- | Returns all files in a directory and its sub directories (in sorted order),
+-- or the empty list if the directory does not exist.
+getFilesRecursive :: FilePath -> IO [FilePath]
+getFilesRecursive dir
+  = B.exCatch (do names <- getDirectoryContents dir
+                  fmap concat $ mapM entry (sort [name | name <- names, name /= ".", name /= ".."]))
+              (\exn -> return [])
+  where
+    entry name
+      = do let fpath = joinPath dir name
+           isDir <- doesDirectoryExist fpath
+           if (isDir) then getFilesRecursive fpath else return [fpath]
+
 doesFileExistAndNotEmpty :: FilePath -> IO Bool
 doesFileExistAndNotEmpty fpath
   = do mbContent <- readTextFile fpath
@@ -353,7 +373,9 @@ copyBinaryIfNewer always srcName outName
               else if always then return GT
               else fileTimeCompare srcName outName
        if (ord == GT)
-        then do copyBinaryFile srcName outName
+        then do same <- if always then return False else sameFileContent srcName outName
+                if (same) then touchFileFrom srcName outName
+                          else copyBinaryFile srcName outName
         else do -- putStrLn $ "no copy for: " ++ srcName ++ " to " ++ outName
                 return ()
 
@@ -363,7 +385,9 @@ copyTextIfNewer always srcName outName
               else if always then return GT
               else fileTimeCompare srcName outName
        if (ord == GT)
-        then do copyTextFile srcName outName
+        then do same <- if always then return False else sameFileContent srcName outName
+                if (same) then touchFileFrom srcName outName
+                          else copyTextFile srcName outName
         else do return ()
 
 copyTextIfNewerWith :: Bool -> FilePath -> FilePath -> (String -> String) -> IO ()
@@ -375,6 +399,56 @@ copyTextIfNewerWith always srcName outName transform
         then do copyTextFileWith srcName outName transform
         else do return ()
 
+-- | Only update the time stamp of `outName` if `srcName` was touched but has the same content
+touchFileFrom :: FilePath -> FilePath -> IO ()
+touchFileFrom srcName outName
+  = do ftime <- getFileTime srcName
+       setFileTime outName ftime
+
+-- | Do two files have the same content? (`False` if either one does not exist)
+sameFileContent :: FilePath -> FilePath -> IO Bool
+sameFileContent fname1 fname2
+  = B.exCatch (do content1 <- BS.readFile fname1
+                  content2 <- BS.readFile fname2
+                  return (content1 == content2))
+              (\exn -> return False)
+
+-- | Move `tmpName` to `outName` unless `outName` has the same content already. In that case
+-- `tmpName` is removed and `outName` keeps its time stamp. Returns `True` if `outName` was replaced.
+moveFileIfChanged :: FilePath -> FilePath -> IO Bool
+moveFileIfChanged tmpName outName
+  = do same <- sameFileContent tmpName outName
+       if (same)
+        then do removeFileIfExists tmpName
+                return False
+        else do renameFile tmpName outName
+                return True
+
+-- | Content hash (as 64-bit FNV-1a in hexadecimal)
+type FileHash = String
+
+hashString :: String -> FileHash
+hashString s
+  = showFileHash (foldl' (\h c -> fnvStep h (fromIntegral (fromEnum c))) fnvBasis s)
+
+-- | Returns the content hash of a file, or the empty string if the file does not exist.
+getFileHash :: FilePath -> IO FileHash
+getFileHash fpath
+  = B.exCatch (do content <- BS.readFile fpath
+                  return $! showFileHash (BS.foldl' (\h w -> fnvStep h (fromIntegral w)) fnvBasis content))
+              (\exn -> return "")
+
+fnvBasis :: Word64
+fnvBasis = 14695981039346656037
+
+fnvStep :: Word64 -> Word64 -> Word64
+fnvStep h x
+  = (h `xor` x) * 1099511628211
+
+showFileHash :: Word64 -> FileHash
+showFileHash h
+  = let hex = showHex h "" in replicate (16 - length hex) '0' ++ hex
+
 removeFileIfExists :: FilePath -> IO ()
 removeFileIfExists fname 
   = B.exCatch (removeFile fname)
@@ -33,10 +33,15 @@ import Data.Char              ( isAlphaNum, toLower, isSpace )
 
 import System.Directory       ( createDirectoryIfMissing, canonicalizePath, getCurrentDirectory, doesDirectoryExist )
 import Data.Maybe             ( catMaybes )
-import Data.List              ( isPrefixOf, intersperse )
+import Data.List              ( isPrefixOf, isSuffixOf, intersperse, sortOn )
 import qualified Data.Set as S
 import Control.Applicative
 import Control.Monad          ( ap, when )
+import Control.Concurrent     ( forkIO )
+import Control.Concurrent.MVar
+import Control.Concurrent.QSem
+import GHC.Conc               ( getNumProcessors )
+import Platform.Runtime       ( unsafePerformIO, finally )
 import qualified Control.Monad.Fail as F
 import Common.Failure
 import Lib.Printer            ( withNewFilePrinter )
@@ -58,7 +63,7 @@ import Syntax.Colorize        ( colorize )
 import Core.GenDoc            ( genDoc )
 import Core.Check             ( checkCore )
 import Core.UnReturn          ( unreturn )
-import Core.OpenResolve       ( openResolve )
+import Core.OpenResolve       ( openResolve, evIndexCount )
 import Core.FunLift           ( liftFunctions )
 import Core.Monadic           ( monTransform )
 import Core.MonadicLift       ( monadicLift )
@@ -279,6 +284,8 @@ compileTypeDef term flags loaded program line input
   These are meant to be called from the interpreter/main compiler
 ---------------------------------------------------------------}
 
+-- Note: C compilation of modules runs in the background (see `ccompileAsync`)
+-- and the top-level compile functions wait for all of them to finish.
 compileModuleOrFile :: Terminal -> Flags -> Modules -> String -> Bool -> IO (Error Loaded)
 compileModuleOrFile term flags modules fname force
   | any (not . validModChar) fname = compileFile term flags modules Object fname
@@ -302,7 +309,7 @@ compileModuleOrFile term flags modules fname force
 
 compileFile :: Terminal -> Flags -> Modules -> CompileTarget () -> FilePath -> IO (Error Loaded)
 compileFile term flags modules compileTarget fpath
-  = runIOErr $
+  = ccompileWaitAfter $ runIOErr $
     do mbP <- liftIO $ searchSourceFile flags "" fpath
        case mbP of
          Nothing -> liftError $ errorMsg (errorFileNotFound flags fpath)
@@ -322,7 +329,7 @@ makeRelativeToPaths paths fname
 
 compileModule :: Terminal -> Flags -> Modules -> Name -> IO (Error Loaded)
 compileModule term flags modules name  -- todo: take force into account
-  = runIOErr $
+  = ccompileWaitAfter $ runIOErr $
     do let imp = ImpProgram (Import name name rangeNull Private)
        loaded <- resolveImports name term flags "" initialLoaded{ loadedModules = modules } [imp]
        -- trace ("compileModule: loaded modules: " ++ show (map modName (loadedModules loaded))) $ return ()
@@ -336,7 +343,7 @@ compileModule term flags modules name  -- todo: take force into account
 ---------------------------------------------------------------}
 compileProgram :: Terminal -> Flags -> Modules -> CompileTarget () -> FilePath -> UserProgram -> IO (Error Loaded)
 compileProgram term flags modules compileTarget fname program
-  = runIOErr $ compileProgram' term flags modules compileTarget  fname program
+  = ccompileWaitAfter $ runIOErr $ compileProgram' term flags modules compileTarget  fname program
 
 
 compileProgramFromFile :: Terminal -> Flags -> Modules -> CompileTarget () -> FilePath -> FilePath -> IOErr Loaded
@@ -650,9 +657,11 @@ resolveModule term flags currentDir modules mimp
                         loadFromSource modules root stem
                 Nothing ->
                   -- trace ("module " ++ show (name) ++ " not yet loaded") $
-                  if (not (rebuild flags) && srcpath /= forceModule flags && ifaceTime >= sourceTime)
-                    then loadFromIface iface root stem
-                    else loadFromSource modules root stem
+                  do upToDate <- if (ifaceTime >= sourceTime) then return True
+                                  else liftIO $ sourceHashUnchanged flags iface srcpath -- only touched?
+                     if (not (rebuild flags) && srcpath /= forceModule flags && upToDate)
+                       then loadFromIface iface root stem
+                       else loadFromSource modules root stem
 
       loadFromSource modules1 root fname
         = -- trace ("loadFromSource: " ++ root ++ "/" ++ fname) $
@@ -690,9 +699,9 @@ resolveModule term flags currentDir modules mimp
              --                            }
              -- (loadedImp,impss) <- resolveImports term flags (dirname iface) loaded (map ImpCore (Core.coreProgImports (modCore mod)))
              (imports,resolved1) <- resolveImportModules name term flags (dirname iface) modules (map ImpCore (Core.coreProgImports (modCore mod)))
-             let latest = maxFileTimes (map modTime imports)
-             -- trace ("loaded iface: " ++ show iface ++ "\n time: "  ++ show (modTime mod) ++ "\n latest: " ++ show (latest)) $ return ()
-             if (latest >= modTime mod
+             importsSame <- liftIO $ importsHashUnchanged iface (importIfaces (modCore mod) resolved1)
+             -- trace ("loaded iface: " ++ show iface ++ "\n imports unchanged: " ++ show importsSame) $ return ()
+             if (not importsSame
                   && not (null source)) -- happens if no source is present but (package) depencies have updated...
                then loadFromSource resolved1 root source -- load from source after all
                else do liftIO $ copyPkgIFaceToOutputDir term flags iface (modCore mod) (modPackageQPath mod) imports
@@ -700,6 +709,57 @@ resolveModule term flags currentDir modules mimp
                        return (mod{ modSourcePath = joinPath root source }, allmods)
 
 
+-- | The content hash of a module source (and the flags that influence its interface) is
+-- stored next to the interface, followed by a hash of the interfaces of its imports.
+-- This way, a source file that is touched (or checked out again) but not changed does not
+-- need to be recompiled, and neither does a module whose imports were recompiled but still
+-- have the same interface.
+sourceHash :: Flags -> FilePath -> IO FileHash
+sourceHash flags srcpath
+  = do hash <- getFileHash srcpath
+       if (null hash) then return ""
+         else return (hashString (unwords [hash, version, buildVariant flags, show (optimize flags)]))
+
+-- | The hash of the interfaces of the imports (or the empty string if an interface is missing).
+importsHash :: [(Name,FilePath)] -> IO FileHash
+importsHash ifaces
+  = do hashes <- mapM (\(name,iface) -> do h <- getFileHash iface
+                                            return (showModName name ++ "=" ++ h))
+                      (sortOn (showModName . fst) ifaces)
+       if (any (isSuffixOf "=") hashes) then return ""
+         else return (hashString (unwords hashes))
+
+-- | The interfaces of the direct imports of a module (as found in `modules`).
+importIfaces :: Core.Core -> [Module] -> [(Name,FilePath)]
+importIfaces core modules
+  = [(modName mod, modPath mod) | imp <- Core.coreProgImports core
+                                , mod <- take 1 (filter (\m -> modName m == Core.importName imp) modules)]
+
+readSourceHash :: FilePath -> IO [FileHash]
+readSourceHash iface
+  = do mbHash <- readTextFile (iface ++ ".hash")
+       return (maybe [] words mbHash)
+
+sourceHashUnchanged :: Flags -> FilePath -> FilePath -> IO Bool
+sourceHashUnchanged flags iface srcpath
+  = do hash <- sourceHash flags srcpath
+       old  <- readSourceHash iface
+       return (not (null hash) && take 1 old == [hash])
+
+importsHashUnchanged :: FilePath -> [(Name,FilePath)] -> IO Bool
+importsHashUnchanged iface imports
+  = do hash <- importsHash imports
+       old  <- readSourceHash iface
+       return (not (null hash) && drop 1 old == [hash])
+
+writeSourceHash :: Flags -> FilePath -> FilePath -> [(Name,FilePath)] -> IO ()
+writeSourceHash flags iface srcpath imports
+  = do hash  <- sourceHash flags srcpath
+       ihash <- importsHash imports
+       if (null hash || null ihash) then removeFileIfExists (iface ++ ".hash")
+                                    else writeTextFile (iface ++ ".hash") (hash ++ " " ++ ihash)
+
+
 lookupImport :: FilePath {- interface name -} -> Modules -> Maybe Module
 lookupImport imp [] = Nothing
 lookupImport imp (mod:mods)
@@ -1039,10 +1099,16 @@ codeGen term flags compileTarget loaded
                  withNewFilePrinter (outBase ++ ".xmp.html") $ \printer ->
                   genDoc cenv (loadedKGamma loaded) (loadedGamma loaded) (modCore mod) printer
 
+       -- report evidence lookups that could not be resolved at compile time
+       let evLookups = evIndexCount (Core.coreProgDefs (modCore mod))
+       when (verbose flags >= 2 && evLookups > 0) $
+         termPhase term ("dynamic evidence lookups: " ++ show evLookups ++ " in " ++ showModName (modName mod))
+
        mbRun <- backend term flags (loadedModules loaded)  compileTarget  outBase (modCore mod)
 
        -- write interface file last so on any error it will not be written
        writeDocW 10000 outIface ifaceDoc
+       writeSourceHash flags outIface (modSourcePath mod) (importIfaces (modCore mod) (loadedModules loaded))
        ftime <- getFileTimeOrCurrent outIface
        let mod1 = (loadedModule loaded){ modTime = ftime }
            loaded1 = loaded{ loadedModule = mod1  }
@@ -1229,8 +1295,11 @@ codeGenC sourceFile newtypes borrowed0 unique0 term flags modules compileTarget
         do termDoc term bcoreDoc
 
       termPhase term ( "generate c: " ++ outBase )
-      writeDocW 120 outC (cdoc <.> linebreak)
-      writeDocW 120 outH (hdoc <.> linebreak)
+      -- only replace the C files if they changed so their time stamps are preserved
+      writeDocW 120 (outC ++ ".tmp") (cdoc <.> linebreak)
+      writeDocW 120 (outH ++ ".tmp") (hdoc <.> linebreak)
+      moveFileIfChanged (outC ++ ".tmp") outC
+      moveFileIfChanged (outH ++ ".tmp") outH
       when (showAsmC flags) (termDoc term (hdoc <//> cdoc))
 
       -- copy libraries
@@ -1239,8 +1308,11 @@ codeGenC sourceFile newtypes borrowed0 unique0 term flags modules compileTarget
           clibs    = clibsFromCore flags bcore 
       extraIncDirs <- fmap concat $ mapM (copyCLibrary term flags cc) eimports
 
-      -- compile      
-      ccompile term flags cc outBase extraIncDirs [outC] 
+      -- compile (in parallel with the code generation of the following modules)
+      -- in a unity build, only the main module is compiled (see `ccompileUnity`)
+      let cheaders = [outName flags (showModName (Core.importName imp)) ++ ".h" | imp <- Core.coreProgImports bcore]
+      when (not (ccompUnity flags)) $
+        ccompileAsync flags (ccompileIfChanged term flags cc outBase extraIncDirs outC (outH:cheaders))
 
       -- compile and link?
       case mbEntry of
@@ -1252,13 +1324,22 @@ codeGenC sourceFile newtypes borrowed0 unique0 term flags modules compileTarget
                 mainName   = if null (outBaseName flags) then mainModName else outBaseName flags
                 mainExe    = outName flags mainName
 
-            -- build kklib for the specified build variant
+            -- build kklib for the specified build variant (in parallel with the modules)
             -- cmakeLib term flags cc "kklib" (ccLibFile cc "kklib") cmakeGeneratorFlag
-            kklibObj <- kklibBuild term flags cc "kklib" (ccObjFile cc "kklib")
+            let kklibObj = outName flags (ccObjFile cc "kklib")
+            ccompileAsync flags (kklibBuild term flags cc "kklib" (ccObjFile cc "kklib") >> return ())
+
+            let mnames = map modName modules ++ [Core.coreProgName core0]
+            unityObjs <- if (not (ccompUnity flags)) then return []
+                          else do unityObj <- ccompileUnity term flags cc outBase mnames (map modCore modules ++ [bcore])
+                                  return [unityObj]
+
+            -- all objects must be compiled before linking
+            ccompileWait
 
             let objs   = [kklibObj] ++
-                         [outName flags (ccObjFile cc (showModName mname)) 
-                         | mname <- (map modName modules ++ [Core.coreProgName core0])]
+                         (if (ccompUnity flags) then unityObjs
+                           else [outName flags (ccObjFile cc (showModName mname)) | mname <- mnames])
                 syslibs= concat [csyslibsFromCore flags mcore | mcore <- map modCore modules]
                          ++ ccompLinkSysLibs flags
                          ++ (if onWindows && not (isTargetWasm (target flags))
@@ -1319,23 +1400,170 @@ codeGenC sourceFile newtypes borrowed0 unique0 term flags modules compileTarget
 
 ccompile :: Terminal -> Flags -> CC -> FilePath -> [FilePath] -> [FilePath] -> IO ()
 ccompile term flags cc ctargetObj extraIncDirs csources 
-  = do let cmdline = concat $
-                      [ [ccPath cc]
-                      , ccFlags cc
-                      , ccFlagsWarn cc
-                      , ccFlagsBuildFromFlags cc flags
-                      , ccFlagsCompile cc
-                      , ccIncludeDir cc (localShareDir flags ++ "/kklib/include")
-                      ]
-                      ++
-                      map (ccIncludeDir cc) (extraIncDirs ++ ccompIncludeDirs flags)
-                      ++
-                      map (ccAddDef cc) (ccompDefs flags)
-                      ++
-                      [ ccTargetObj cc (notext ctargetObj)
-                      , csources
-                      ]
-       runCommand term flags cmdline
+  = runCommand term flags (ccompileCommand flags cc ctargetObj extraIncDirs csources)
+
+-- | A unity build compiles the generated C files of all modules as a single translation unit
+-- (like kklib's `src/all.c`). Private functions are then `static` (see `kk_decl_private`)
+-- and the C compiler can inline across modules.
+ccompileUnity :: Terminal -> Flags -> CC -> FilePath -> [Name] -> [Core.Core] -> IO FilePath
+ccompileUnity term flags cc outBase mnames cores
+  = do let unityBase = outBase ++ "-unity"
+           unityC    = unityBase ++ ".c"
+           csources  = [outName flags (showModName mname) ++ ".c" | mname <- mnames]
+           cheaders  = [outName flags (showModName mname) ++ ".h" | mname <- mnames]
+           unityDoc  = vcat $ [ text "// Koka unity build:" <+> text (notdir outBase)
+                              , text "#define KK_UNITY_BUILD 1"
+                              , text "#if defined(__GNUC__)"
+                              , text "#pragma GCC diagnostic ignored \"-Wunused-function\""
+                              , text "#endif" ]
+                              ++ [text "#include" <+> dquotes (text (notdir csource)) | csource <- csources]
+       termPhase term ("generate c: " ++ unityBase)
+       writeDocW 120 (unityC ++ ".tmp") (unityDoc <.> linebreak)
+       moveFileIfChanged (unityC ++ ".tmp") unityC
+       extraIncDirs <- fmap concat $ mapM (copyCLibrary term flags cc) (concatMap (externalImportsFromCore (target flags)) cores)
+       ccompileAsync flags (ccompileIfChanged term flags cc unityBase extraIncDirs unityC (csources ++ cheaders))
+       return (ccObjFile cc unityBase)
+
+-- | Compile a generated C file unless the object file was compiled before from the same
+-- command, C source, and headers. The content hash of those is stored next to the object file
+-- (and does not depend on file time stamps). The headers are all kklib headers, the given
+-- `cheaders`, and every header that is (transitively) included by any of those or the C source.
+-- Absolute paths are made relative to the build root (and share directory) before hashing
+-- so the hashes can be shared between checkouts.
+ccompileIfChanged :: Terminal -> Flags -> CC -> FilePath -> [FilePath] -> FilePath -> [FilePath] -> IO ()
+ccompileIfChanged term flags cc ctargetObj extraIncDirs csource cheaders
+  = do let cmdline  = ccompileCommand flags cc ctargetObj extraIncDirs [csource]
+           objFile  = ccObjFile cc (notext ctargetObj)
+           hashFile = objFile ++ ".hash"
+           kklibInc = localShareDir flags ++ "/kklib/include"
+       kklibHeaders <- getFilesRecursive kklibInc
+       cincludes    <- cincludeClosure (kklibInc : extraIncDirs ++ ccompIncludeDirs flags) (csource : cheaders ++ kklibHeaders)
+       relative     <- cpathRelative flags
+       hashes       <- mapM (\fpath -> do h <- getFileHash fpath
+                                          return (relative fpath ++ "=" ++ h)) cincludes
+       let hash = hashString (unwords (map relative cmdline ++ hashes))
+       objExist <- doesFileExist objFile
+       mbOld    <- readTextFile hashFile
+       if (objExist && not (rebuild flags) && ccompPgo flags /= "use" && mbOld == Just hash)  -- profiles are not part of the hash
+         then termPhase term ("c compilation is up-to-date: " ++ objFile)
+         else do removeFileIfExists hashFile
+                 ccompile term flags cc ctargetObj extraIncDirs [csource]
+                 writeTextFile hashFile hash
+
+-- | Returns a function that replaces the absolute build root and share directory in a
+-- path (or command line argument) with a fixed name.
+cpathRelative :: Flags -> IO (String -> String)
+cpathRelative flags
+  = do buildRoot <- fmap normalize $ canonicalizePath (buildDir flags)
+       shareRoot <- fmap normalize $ canonicalizePath (localShareDir flags)
+       let roots = [(buildRoot,"$(builddir)"),(shareRoot,"$(sharedir)")]
+           relative s  = replaceRoots roots (normalize s)
+           replaceRoots [] s = s
+           replaceRoots ((root,name):rest) s = replaceRoots rest (replacePrefix root name s)
+           replacePrefix root name s
+             | null root || null s   = s
+             | root `isPrefixOf` s   = name ++ replacePrefix root name (drop (length root) s)
+             | otherwise             = head s : replacePrefix root name (tail s)
+       return relative
+
+-- | Returns the given C files and all headers that they (transitively) include. Included headers
+-- are searched relative to the including file and in the include directories. Headers that are not
+-- found (like system headers) are skipped. The result is sorted and has no duplicates.
+cincludeClosure :: [FilePath] -> [FilePath] -> IO [FilePath]
+cincludeClosure incDirs fpaths
+  = closure S.empty fpaths
+  where
+    closure visited []  = return (S.toList visited)
+    closure visited (fpath:rest)
+      | fpath `S.member` visited  = closure visited rest
+      | otherwise = do mbContent <- readTextFile fpath
+                       let includes = maybe [] cincludes mbContent
+                       found <- mapM (searchInclude (dirname fpath : incDirs)) includes
+                       closure (S.insert fpath visited) (catMaybes found ++ rest)
+
+    searchInclude [] _ = return Nothing
+    searchInclude (dir:dirs) fname
+      = do let fpath = joinPath dir fname
+           exist <- doesFileExist fpath
+           if (exist) then return (Just fpath) else searchInclude dirs fname
+
+    cincludes content
+      = [fname | line <- lines content, Just fname <- [cinclude (dropWhile isSpace line)]]
+
+    cinclude ('#':line)
+      = case dropWhile isSpace line of
+          ('i':'n':'c':'l':'u':'d':'e':rest)
+            -> case dropWhile isSpace rest of
+                 ('"':fname) -> Just (takeWhile (/='"') fname)
+                 ('<':fname) -> Just (takeWhile (/='>') fname)
+                 _           -> Nothing
+          _ -> Nothing
+    cinclude _ = Nothing
+
+ccompileCommand :: Flags -> CC -> FilePath -> [FilePath] -> [FilePath] -> [String]
+ccompileCommand flags cc ctargetObj extraIncDirs csources
+  = concat $
+    [ [ccPath cc]
+    , ccFlags cc
+    , ccFlagsWarn cc
+    , ccFlagsBuildFromFlags cc flags
+    , ccFlagsCompile cc
+    , ccIncludeDir cc (localShareDir flags ++ "/kklib/include")
+    ]
+    ++
+    map (ccIncludeDir cc) (extraIncDirs ++ ccompIncludeDirs flags)
+    ++
+    map (ccAddDef cc) (ccompDefs flags)
+    ++
+    [ ccTargetObj cc (notext ctargetObj)
+    , csources
+    ]
+
+
+
+{---------------------------------------------------------------
+  Parallel C compilation
+  C compilations are started in the background and run in a job
+  pool of `ccompJobs` slots (by default the number of processors).
+---------------------------------------------------------------}
+
+data CJobs = CJobs{ cjobsSem :: Maybe QSem, cjobsPending :: [MVar (Maybe String)] }
+
+{-# NOINLINE cjobs #-}
+cjobs :: MVar CJobs
+cjobs = unsafePerformIO $ newMVar (CJobs Nothing [])
+
+-- | Run a C compilation in the background; use `ccompileWait` to wait for its completion.
+ccompileAsync :: Flags -> IO () -> IO ()
+ccompileAsync flags action  | ccompJobs flags < 0 || ccompJobs flags == 1
+  = action
+ccompileAsync flags action
+  = do done <- newEmptyMVar
+       sem  <- modifyMVar cjobs $ \(CJobs mbSem pending) ->
+                 do sem <- case mbSem of
+                             Just sem -> return sem
+                             Nothing  -> do n <- if (ccompJobs flags > 0) then return (ccompJobs flags) else getNumProcessors
+                                            newQSem (max 1 n)
+                    return (CJobs (Just sem) (done:pending), sem)
+       _ <- forkIO $
+            do waitQSem sem
+               res <- ((action >> return Nothing) `catchIO` (\msg -> return (Just msg)))
+                        `finally` signalQSem sem
+               putMVar done res
+       return ()
+
+-- | Wait for all background C compilations and raise the first error (if any).
+ccompileWait :: IO ()
+ccompileWait
+  = do pending <- modifyMVar cjobs $ \(CJobs mbSem pending) -> return (CJobs mbSem [], pending)
+       results <- mapM takeMVar (reverse pending)
+       case catMaybes results of
+         (msg:_) -> raiseIO msg
+         []      -> return ()
+
+ccompileWaitAfter :: IO a -> IO a
+ccompileWaitAfter io
+  = io `finally` ccompileWait
 
 
 -- copy static C library to the output directory (so we can link and/or bundle) and 
@@ -1539,7 +1767,14 @@ kklibBuild term flags cc name {-kklib-} objFile {-libkklib.o-}
        exist <- doesFileExist objPath
        let binObjPath = joinPath (localLibDir flags) (buildVariant flags ++ "/" ++ objFile)
        let srcLibDir  = joinPath (localShareDir flags) (name)
-       binExist <- doesFileExist binObjPath
+       -- the pre-compiled binary cannot be used with lto or pgo, and we rebuild if these change
+       let modeFile  = objPath ++ ".mode"
+           modeOf lto pgo = "lto=" ++ show lto ++ ",pgo=" ++ pgo
+           mode      = modeOf (ccompLto flags) (ccompPgo flags)
+           isDefault = (mode == modeOf False "")
+       mbOldMode <- readTextFile modeFile
+       let modeChanged = (maybe (modeOf False "") id mbOldMode /= mode) || ccompPgo flags == "use"
+       binExist <- if (isDefault) then doesFileExist binObjPath else return False
        binNewer <- if (not binExist) then return False
                    else if (not exist) then return True
                    else do cmp <- fileTimeCompare binObjPath objPath
@@ -1549,11 +1784,12 @@ kklibBuild term flags cc name {-kklib-} objFile {-libkklib.o-}
                    else do cmp <- fileTimeCompare (srcLibDir ++ "/include/kklib.h") objPath
                            return (cmp==GT)
        -- putStrLn ("binObjPath: " ++ binObjPath ++ ", newer: " ++ show binNewer)
-       if (not binNewer && not srcNewer && not (rebuild flags)) 
+       if (not binNewer && not srcNewer && not modeChanged && not (rebuild flags)) 
         then return ()
          else if (binNewer)
            then -- use pre-compiled installed binary
-                copyBinaryFile binObjPath objPath
+                do copyBinaryFile binObjPath objPath
+                   writeTextFile modeFile mode
            else -- todo: check for installed binaries for the library
                 -- compile kklib from sources
                 do termDoc term $ color (colorInterpreter (colorScheme flags)) (text ("compile:")) <+>
@@ -1566,6 +1802,7 @@ kklibBuild term flags cc name {-kklib-} objFile {-libkklib.o-}
                                                     [("KK_COMP_VERSION","\"" ++ version ++ "\""),
                                                      ("KK_CC_NAME", "\"" ++ ccName cc ++ "\"")] }
                    ccompile term flags1 cc objPath [] [joinPath srcLibDir "src/all.c"] 
+                   writeTextFile modeFile mode
        return objPath
 
 
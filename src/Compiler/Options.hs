@@ -35,7 +35,7 @@ import Data.List              ( intersperse )
 import Control.Monad          ( when )
 import qualified System.Info  ( os, arch )
 import System.Environment     ( getArgs )
-import System.Directory       ( doesFileExist, doesDirectoryExist, getHomeDirectory, getTemporaryDirectory )
+import System.Directory       ( doesFileExist, doesDirectoryExist, getHomeDirectory, getTemporaryDirectory, getDirectoryContents, makeAbsolute )
 import Platform.GetOptions
 import Platform.Config
 import Lib.PPrint
@@ -183,6 +183,10 @@ data Flags
          , asan             :: Bool
          , useStdAlloc      :: Bool -- don't use mimalloc for better asan and valgrind support
          , optSpecialize    :: Bool
+         , ccompJobs        :: Int  -- parallel C compilations (0 for the number of processors)
+         , ccompLto         :: Bool     -- use link-time optimization
+         , ccompPgo         :: String   -- profile guided optimization: "", "gen", or "use"
+         , ccompUnity       :: Bool     -- compile the program and its imports as a single C translation unit
          }
 
 flagsNull :: Flags
@@ -276,6 +280,10 @@ flagsNull
           False -- use asan
           False -- use stdalloc
           True  -- use specialization (only used if optimization level >= 1)
+          0     -- C compilation jobs (0 = number of processors)
+          False -- lto
+          ""    -- pgo
+          False -- unity build
 
 isHelp Help = True
 isHelp _    = False
@@ -310,6 +318,7 @@ options = (\(xss,yss) -> (concat xss, concat yss)) $ unzip
  , flag   ['g'] ["debug"]           (\b f -> f{debug=b})            "emit debug information (on by default)" 
  , numOption 1 "n" ['v'] ["verbose"] (\i f -> f{verbose=i})         "verbosity 'n' (0=quiet, 1=default, 2=trace)"
  , flag   ['r'] ["rebuild"]         (\b f -> f{rebuild = b})        "rebuild all"
+ , numOption 0 "n" ['j'] ["jobs"]     (\i f -> f{ccompJobs=i})       "run 'n' C compilations in parallel (0=number of processors)"
  , flag   ['l'] ["library"]         (\b f -> f{library=b, evaluate=if b then False else (evaluate f) }) "generate a library"
  , configstr [] ["target"]          (map fst targets) "tgt" targetFlag  ("target: " ++ show (map fst targets))
  -- , config []    ["host"]            [("node",Node),("browser",Browser)] "host" (\h f -> f{ target=JS, host=h}) "specify host for javascript: <node|browser>"
@@ -337,6 +346,9 @@ options = (\(xss,yss) -> (concat xss, concat yss)) $ unzip
  , option []    ["node"]            (ReqArg nodeFlag "cmd")         "use <cmd> to execute node"
  , option []    ["wasmrun"]         (ReqArg wasmrunFlag "cmd")      "use <cmd> to execute wasm"
  , option []    ["editor"]          (ReqArg editorFlag "cmd")       "use <cmd> as editor"
+ , flag   []    ["lto"]             (\b f -> f{ccompLto=b})         "use link-time optimization (clang and gcc)"
+ , flag   []    ["unity"]           (\b f -> f{ccompUnity=b})       "compile the program and its imports as a single C file"
+ , configstr [] ["pgo"] ["gen","use"] "mode" (\s f -> f{ccompPgo=s})  "profile guided optimization: generate a profile when running\nthe program (gen), and use it in the next build (use)"
  , option []    ["stack"]           (ReqArg stackFlag "size")       "set stack size (0 for platform default)"
  , option []    ["heap"]            (ReqArg heapFlag "size")        "set reserved heap size (0 for platform default)"
  , option []    ["color"]           (ReqArg colorFlag "colors")     "set colors"
@@ -653,7 +665,7 @@ processOptions flags0 opts
                    ccmd <- if (ccompPath flags == "") then detectCC (target flags)
                            else if (ccompPath flags == "mingw") then return "gcc"
                            else return (ccompPath flags)
-                   (cc,asan) <- ccFromPath flags ccmd
+                   (cc,asan) <- ccFromPath flags{ buildDir = buildDir } ccmd
                    ccCheckExist cc
                    let stdAlloc = if asan then True else useStdAlloc flags   -- asan implies useStdAlloc
                        cdefs    = ccompDefs flags 
@@ -1081,7 +1093,12 @@ ccFromPath flags path
             putStrLn ("\nwarning: a wasm target should use the emscripten compiler (emcc),\n  but currently '" 
                        ++ ccPath cc ++ "' is used." 
                        ++ "\n  hint: specify the emscripten path using --cc=<emcc path>?")   
-          if (asan flags)
+          (cc1,useAsan) <- ccWithSanitizer cc
+          cc2 <- ccWithLtoPgo flags cc1
+          return (cc2,useAsan)
+  where
+    ccWithSanitizer cc
+      = if (asan flags)
             then if (not (ccName cc `startsWith` "clang" || ccName cc `startsWith` "gcc" || ccName cc `startsWith` "g++"))
                     then do putStrLn "warning: can only use address sanitizer with clang or gcc (--fasan is ignored)"
                             return (cc,False)
@@ -1096,6 +1113,47 @@ ccFromPath flags path
             then return (cc{ ccName = ccName cc ++ "-stdalloc" }, False)
             else return (cc,False)
 
+-- | Add flags for link-time optimization (`--lto`) and profile guided optimization (`--pgo`).
+-- The flags are used consistently for compiling modules, kklib, and linking.
+-- Profiles are written to and read from `<builddir>/pgo`.
+ccWithLtoPgo :: Flags -> CC -> IO CC
+ccWithLtoPgo flags cc  | not (ccompLto flags) && null (ccompPgo flags)
+  = return cc
+ccWithLtoPgo flags cc  | not (isClang || ccName cc `startsWith` "gcc" || ccName cc `startsWith` "g++" || ccName cc == "cc")
+  = do putStrLn "warning: can only use link-time or profile guided optimization with clang or gcc (--lto and --pgo are ignored)"
+       return cc
+  where
+    isClang = ccName cc `startsWith` "clang" && not (ccName cc `startsWith` "clang-cl")
+ccWithLtoPgo flags cc
+  = do profileDir <- makeAbsolute (joinPath (buildDir flags) "pgo")
+       pgo <- case ccompPgo flags of
+                "gen" -> return ["-fprofile-generate=" ++ profileDir]
+                "use" | isClang
+                      -> do profile <- clangMergeProfiles profileDir
+                            return ["-fprofile-use=" ++ profile, "-Wno-profile-instr-unprofiled", "-Wno-profile-instr-out-of-date"]
+                "use" -> return ["-fprofile-use=" ++ profileDir, "-fprofile-correction", "-Wno-missing-profile"]
+                _     -> return []
+       let lto = if (ccompLto flags) then ["-flto"] else []
+       return cc{ ccFlagsCompile = ccFlagsCompile cc ++ lto ++ pgo
+                , ccFlagsLink    = ccFlagsLink cc ++ lto ++ pgo }
+  where
+    isClang = ccName cc `startsWith` "clang" && not (ccName cc `startsWith` "clang-cl")
+
+    -- clang writes raw profiles that need to be merged first
+    clangMergeProfiles profileDir
+      = do let profile = joinPath profileDir "default.profdata"
+           exist <- doesDirectoryExist profileDir
+           raws  <- if (exist) then fmap (filter (`endsWith` ".profraw")) (getDirectoryContents profileDir)
+                               else return []
+           mbProfData <- searchProgram "llvm-profdata"
+           case mbProfData of
+             Just profData | not (null raws)
+               -> runCmd profData (["merge", "-output=" ++ profile] ++ map (joinPath profileDir) raws)
+             Nothing | not (null raws)
+               -> putStrLn "warning: cannot find llvm-profdata to merge the profiles for --pgo=use"
+             _ -> return ()
+           return profile
+
 ccCheckExist :: CC -> IO ()
 ccCheckExist cc
   = do paths  <- getEnvPaths "PATH"
@@ -45,7 +45,7 @@ module Core.Core ( -- Data structures
                    , openEffectExpr
                    , makeIfExpr
                    , makeInt32, makeSizeT
-                   , makeEvIndex
+                   , makeEvIndex, effectOffset, effectLabelFromHandler
                    , makeList, makeVector
                    , makeDef, makeTDef, makeStats, makeDefsLet, makeDefExpr
                    , makeDropSpecial
@@ -1108,6 +1108,21 @@ makeEvIndex i
   = let sizet = Var (TName nameSSizeT (typeFun [(nameNil,typeInt)] typeTotal typeEvIndex)) (InfoArity 1 0 )
     in App sizet [Lit (LitInt i)]
 
+-- | The offset of effect label `l` in a fixed effect type; used to resolve evidence indices statically
+effectOffset :: Name -> Type -> Integer
+effectOffset l effTp
+  = let (ls,_) = extractHandledEffect effTp
+        ofs = findMatch 0 l ls
+    in -- trace ("found offset " ++ show ofs ++ " for " ++ show l ++ " in " ++ show (map (show . labelName) ls)) $
+       ofs
+  where
+    findMatch i lname (l:ls)  = if (labelName l == lname) then i else findMatch (i+1) lname ls
+    findMatch i lname []      = failure $ "Core.Core.effectOffset: label " ++ show lname ++ " is not in the labels"
+
+effectLabelFromHandler :: Type -> Name
+effectLabelFromHandler tp
+  = fromHandlerName (labelName tp)
+
 makeSizeT :: Integer -> Expr
 makeSizeT i | i < 0 = failure $ ("Core.Core.makeSizeT: size_t < 0: " ++ show i)
 makeSizeT i
@@ -10,12 +10,13 @@
 -- Transform .open to specific open calls
 -----------------------------------------------------------------------------
 
-module Core.OpenResolve(  openResolve ) where
+module Core.OpenResolve(  openResolve, evIndexCount ) where
 
 
 import qualified Lib.Trace
 import Control.Monad
 import Control.Applicative
+import Data.Monoid( Sum(..) )
 
 import Lib.PPrint
 import Common.Failure
@@ -94,6 +95,15 @@ resExpr env expr
       _ -> expr  -- var,lit
 
 
+-- | The number of evidence lookups (`.evv-index` calls) that are not resolved statically.
+evIndexCount :: DefGroups -> Int
+evIndexCount defGroups
+  = getSum (mconcat [foldMapExpr isEvIndex (defExpr def) | def <- flattenDefGroups defGroups])
+  where
+    isEvIndex (App (TypeApp (Var evvIndex _) _) _) | getName evvIndex == nameEvvIndex = Sum 1
+    isEvIndex _ = Sum 0
+
+
 resBranch :: Env -> Branch -> Branch
 resBranch env (Branch pat guards)
   = Branch pat (map (resGuard env) guards)
@@ -161,6 +171,8 @@ resOpen (Env penv gamma) eopen effFrom effTo tpFrom tpTo@(TFun targs _ tres) exp
                              (evExprs ++ [exprVar] ++ [Var p InfoNone | p <- params])
                            
                    
+                 evIndexOf l  | isEffectFixed effTo   -- resolve statically if the effect row is known
+                   = makeEvIndex (effectOffset (labelName l) effTo)
                  evIndexOf l
                    = let (htagTp,hndTp)
                              = let (name,_,tpArgs) = labelNameEx l
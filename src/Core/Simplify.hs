@@ -596,28 +596,6 @@ extractMatchOnCon n (Branch patterns guards) = failure $ "Core.Simplify.bottomUp
 
 
 
-{--------------------------------------------------------------------------
-  Effects
---------------------------------------------------------------------------}
-
--- effectOffset (effectTypeFromHandler hndTp) effTp)
-effectLabelFromHandler :: Type -> Name
-effectLabelFromHandler tp
-  = fromHandlerName (labelName tp)
-
-effectOffset :: Name -> Type -> Integer
-effectOffset l effTp
-  = let (ls,_) = extractHandledEffect effTp
-        ofs = findMatch 0 l ls
-    in -- trace ("found offset " ++ show ofs ++ " for " ++ show l ++ " in " ++ show (map (show . labelName) ls)) $    
-       ofs
-
-findMatch :: Integer -> Name -> [Type] -> Integer
-findMatch i lname (l:ls)  = if (labelName l == lname) then i else findMatch (i+1) lname ls
-findMatch i lname []      = failure $ "Core.Simplify.findMatch: label " ++ show lname ++ " is not in the labels"
-
-
-
 {--------------------------------------------------------------------------
   Definitions
 --------------------------------------------------------------------------}